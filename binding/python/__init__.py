@@ -11,4 +11,5 @@
 
 from ._eagle import *
 from ._factory import *
+from ._sharded import *
 from ._util import *
@@ -10,6 +10,7 @@
 #
 
 import os
+import threading
 from ctypes import *
 from enum import Enum
 from typing import Sequence, Tuple
@@ -158,6 +159,8 @@ class EagleProfiler(object):
     """
     Python binding for the profiler of the Eagle speaker recognition engine.
     It enrolls a speaker given a set of utterances and then constructs a profile for the enrolled speaker.
+    An instance may be shared between threads: calls are serialized by a per-object lock because the engine
+    accumulates the enrollment state of a single speaker.
     """
 
     class CEagleProfiler(Structure):
@@ -259,6 +262,8 @@ class EagleProfiler(object):
         version_func.restype = c_char_p
         self._version = version_func().decode('utf-8')
 
+        self._lock = threading.Lock()
+
     def enroll(self, pcm: Sequence[int]) -> Tuple[float, EagleProfilerEnrollFeedback]:
         """
         Enrolls a speaker. This function should be called multiple times with different utterances of the same speaker
@@ -290,12 +295,13 @@ class EagleProfiler(object):
 
         feedback_code = c_int()
         percentage = c_float()
-        status = self._enroll_func(
-            self._eagle_profiler,
-            c_pcm,
-            len(c_pcm),
-            byref(feedback_code),
-            byref(percentage))
+        with self._lock:
+            status = self._enroll_func(
+                self._eagle_profiler,
+                c_pcm,
+                len(c_pcm),
+                byref(feedback_code),
+                byref(percentage))
         feedback = EagleProfilerEnrollFeedback(feedback_code.value)
         if status is not PicovoiceStatuses.SUCCESS:
             raise _PICOVOICE_STATUS_TO_EXCEPTION[status]()
@@ -311,10 +317,11 @@ class EagleProfiler(object):
         """
 
         profile = (c_byte * self._profile_size)()
-        status = self._export_func(
-            self._eagle_profiler,
-            byref(profile)
-        )
+        with self._lock:
+            status = self._export_func(
+                self._eagle_profiler,
+                byref(profile)
+            )
         if status is not PicovoiceStatuses.SUCCESS:
             raise _PICOVOICE_STATUS_TO_EXCEPTION[status]()
 
@@ -326,7 +333,8 @@ class EagleProfiler(object):
         It should be called before starting a new enrollment session.
         """
 
-        status = self._reset_func(self._eagle_profiler)
+        with self._lock:
+            status = self._reset_func(self._eagle_profiler)
         if status is not PicovoiceStatuses.SUCCESS:
             raise _PICOVOICE_STATUS_TO_EXCEPTION[status]()
 
@@ -335,7 +343,8 @@ class EagleProfiler(object):
         Releases resources acquired by Eagle Profiler.
         """
 
-        self._delete_func(self._eagle_profiler)
+        with self._lock:
+            self._delete_func(self._eagle_profiler)
 
     @property
     def min_enroll_samples(self) -> int:
@@ -366,6 +375,9 @@ class Eagle(object):
     """
     Python binding for Eagle speaker recognition engine.
     It processes incoming audio in consecutive frames and emits a similarity score for each enrolled speaker.
+    An instance may be shared between threads, including on free-threaded builds of CPython: calls are serialized by a
+    per-object lock because the engine keeps the state of one audio stream. To use several cores, create one instance
+    per stream and thread; the engine runs without holding the GIL, so such instances process frames in parallel.
     """
 
     class CEagle(Structure):
@@ -436,7 +448,7 @@ class Eagle(object):
             POINTER(c_float)]
         self._process_func.restype = PicovoiceStatuses
 
-        self._scores = (c_float * len(speaker_profiles))()
+        self._num_speakers = len(speaker_profiles)
 
         self._reset_func = library.pv_eagle_reset
         self._reset_func.argtypes = [POINTER(self.CEagle)]
@@ -451,6 +463,8 @@ class Eagle(object):
         version_func.restype = c_char_p
         self._version = version_func().decode('utf-8')
 
+        self._lock = threading.Lock()
+
     def process(self, pcm: Sequence[int]) -> Sequence[float]:
         """
         Processes a frame of audio and returns a list of similarity scores for each speaker profile.
@@ -469,12 +483,15 @@ class Eagle(object):
         frame_type = c_int16 * self.frame_length
         pcm = frame_type(*pcm)
 
-        status = self._process_func(self._eagle, pcm, self._scores)
+        # a buffer per call, so that a concurrent call cannot overwrite the scores before they are copied out
+        scores = (c_float * self._num_speakers)()
+        with self._lock:
+            status = self._process_func(self._eagle, pcm, scores)
         if status is not PicovoiceStatuses.SUCCESS:
             raise _PICOVOICE_STATUS_TO_EXCEPTION[status]()
 
         # noinspection PyTypeChecker
-        return [float(score) for score in self._scores]
+        return [float(score) for score in scores]
 
     def reset(self) -> None:
         """
@@ -483,7 +500,8 @@ class Eagle(object):
         in audio context.
         """
 
-        status = self._reset_func(self._eagle)
+        with self._lock:
+            status = self._reset_func(self._eagle)
         if status is not PicovoiceStatuses.SUCCESS:
             raise _PICOVOICE_STATUS_TO_EXCEPTION[status]()
 
@@ -492,7 +510,8 @@ class Eagle(object):
         Releases resources acquired by Eagle.
         """
 
-        self._delete_func(self._eagle)
+        with self._lock:
+            self._delete_func(self._eagle)
 
     @property
     def sample_rate(self) -> int:
@@ -0,0 +1,258 @@
+#
+# Copyright 2023 Picovoice Inc.
+#
+# You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+# file accompanying this source.
+#
+# Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+# an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+# specific language governing permissions and limitations under the License.
+#
+
+import time
+from multiprocessing.connection import Client, Connection, Listener, wait
+from typing import List, Optional, Sequence, Tuple
+
+from ._eagle import Eagle, EagleError, EagleInvalidArgumentError, EagleProfile
+
+
+class EagleShardServer(object):
+    """
+    Serves one shard of a speaker catalogue to an `EagleShardCoordinator`. It owns an Eagle instance created with the
+    profiles of its shard, processes every frame the coordinator sends, and replies with the best-scoring speakers of
+    the shard. Errors raised by the engine are sent back to the coordinator, and the shard keeps serving.
+    """
+
+    def __init__(
+            self,
+            access_key: str,
+            model_path: str,
+            library_path: str,
+            speaker_ids: Sequence[str],
+            speaker_profiles: Sequence[EagleProfile],
+            authkey: bytes,
+            address: Tuple[str, int] = ('localhost', 0)) -> None:
+        """
+        Constructor.
+
+        :param access_key: AccessKey obtained from Picovoice Console (https://console.picovoice.ai/)
+        :param model_path: Absolute path to file containing model parameters (.pv file).
+        :param library_path: Absolute path to Eagle's dynamic library.
+        :param speaker_ids: Identifiers of the speakers in this shard, reported back with their scores.
+        :param speaker_profiles: Profiles of the speakers in this shard, in the same order as `speaker_ids`.
+        :param authkey: Shared secret the coordinator has to present. Messages are pickled, so only authenticated
+        peers may connect.
+        :param address: Host and port to listen on. Port 0 picks a free port, available through `.address`.
+        """
+
+        if len(authkey) == 0:
+            raise EagleInvalidArgumentError("`authkey` should be a non-empty byte string.")
+
+        if len(speaker_ids) != len(speaker_profiles):
+            raise EagleInvalidArgumentError("`speaker_ids` and `speaker_profiles` should have the same length.")
+
+        self._speaker_ids = list(speaker_ids)
+        self._eagle = Eagle(
+            access_key=access_key,
+            model_path=model_path,
+            library_path=library_path,
+            speaker_profiles=speaker_profiles)
+        self._listener = Listener(address, authkey=authkey)
+
+    @property
+    def address(self) -> Tuple[str, int]:
+        """
+        Address the shard listens on.
+        """
+
+        return self._listener.address
+
+    @property
+    def frame_length(self) -> int:
+        """
+        Number of audio samples per frame expected by the shard's engine, to be passed to `EagleShardCoordinator`.
+        """
+
+        return self._eagle.frame_length
+
+    def serve(self) -> None:
+        """
+        Serves coordinators one at a time until the listener is closed by `.delete()`. Each coordinator session starts
+        from a reset engine.
+        """
+
+        while True:
+            try:
+                connection = self._listener.accept()
+            except OSError:
+                return
+
+            with connection:
+                self._serve_connection(connection)
+
+    def delete(self) -> None:
+        """
+        Stops listening and releases resources acquired by Eagle.
+        """
+
+        self._listener.close()
+        self._eagle.delete()
+
+    def _serve_connection(self, connection: Connection) -> None:
+        # resets are not acknowledged, so a failed one is reported in reply to the next frame
+        reset_error = self._reset()
+        while True:
+            try:
+                request = connection.recv()
+            except (EOFError, OSError):
+                return
+
+            if request[0] == 'process':
+                _, sequence, pcm, top_k = request
+                if reset_error is not None:
+                    connection.send(('error', sequence, reset_error))
+                    reset_error = None
+                    continue
+
+                try:
+                    scores = self._eagle.process(pcm)
+                except EagleError as e:
+                    connection.send(('error', sequence, e))
+                    continue
+
+                matches = sorted(zip(self._speaker_ids, scores), key=lambda x: x[1], reverse=True)[:top_k]
+                connection.send(('scores', sequence, matches))
+            elif request[0] == 'reset':
+                reset_error = self._reset()
+            elif request[0] == 'close':
+                return
+
+    def _reset(self) -> Optional[EagleError]:
+        try:
+            self._eagle.reset()
+            return None
+        except EagleError as e:
+            return e
+
+
+class EagleShardCoordinator(object):
+    """
+    Identifies speakers against a catalogue partitioned across several `EagleShardServer` nodes. Every frame is
+    scattered to all shards, and their top matches are gathered and merged into a global ranking. Shards that do not
+    reply within the timeout are left out of that frame's result instead of delaying it; they keep processing every
+    frame, so their state stays in sync and their late replies are discarded. Shards whose connection is lost are
+    reported as missing from then on. An error raised by a shard's engine is re-raised by `.process()`.
+    """
+
+    def __init__(
+            self,
+            addresses: Sequence[Tuple[str, int]],
+            authkey: bytes,
+            frame_length: int,
+            timeout_sec: float = 0.1) -> None:
+        """
+        Constructor.
+
+        :param addresses: Addresses of the shard servers.
+        :param authkey: Shared secret configured on the shard servers.
+        :param frame_length: Number of audio samples per frame expected by the shards' engines (`Eagle.frame_length`).
+        :param timeout_sec: Time to wait for the shards to reply to a frame before returning a partial result.
+        """
+
+        if len(addresses) == 0:
+            raise EagleInvalidArgumentError("At least one shard address is required.")
+
+        if frame_length < 1:
+            raise EagleInvalidArgumentError("`frame_length` should be a positive integer.")
+
+        self._connections = [Client(address, authkey=authkey) for address in addresses]
+        self._is_connected = [True] * len(self._connections)
+        self._frame_length = frame_length
+        self._timeout_sec = timeout_sec
+        self._sequence = 0
+
+    def process(self, pcm: Sequence[int], top_k: int = 1) -> Tuple[List[Tuple[str, float]], List[int]]:
+        """
+        Processes a frame of audio on every shard and merges their results.
+
+        :param pcm: A frame of `frame_length` audio samples, as accepted by `Eagle.process()`.
+        :param top_k: Number of best-scoring speakers to return.
+        :return: Tuple of the `top_k` best `(speaker_id, score)` pairs across the shards that replied in time, best
+        first, and the indices of the shards that did not.
+        """
+
+        if top_k < 1:
+            raise EagleInvalidArgumentError("`top_k` should be a positive integer.")
+
+        # a frame every shard rejects would otherwise be sent to all of them
+        if len(pcm) != self._frame_length:
+            raise EagleInvalidArgumentError(
+                "Length of input frame %d does not match required frame length %d" % (len(pcm), self._frame_length))
+
+        self._sequence += 1
+        pcm = list(pcm)
+        pending = []
+        for i, connection in enumerate(self._connections):
+            if self._is_connected[i]:
+                try:
+                    connection.send(('process', self._sequence, pcm, top_k))
+                    pending.append(connection)
+                except OSError:
+                    self._is_connected[i] = False
+
+        matches = []
+        replied = set()
+        deadline = time.monotonic() + self._timeout_sec
+        while len(pending) > 0:
+            remaining_sec = deadline - time.monotonic()
+            if remaining_sec <= 0:
+                break
+
+            for connection in wait(pending, timeout=remaining_sec):
+                try:
+                    kind, sequence, payload = connection.recv()
+                except (EOFError, OSError):
+                    self._is_connected[self._connections.index(connection)] = False
+                    pending.remove(connection)
+                    continue
+
+                # replies to earlier frames that arrived after their deadline are dropped
+                if sequence == self._sequence:
+                    if kind == 'error':
+                        raise payload
+                    matches.extend(payload)
+                    replied.add(self._connections.index(connection))
+                    pending.remove(connection)
+
+        missing_shards = [i for i in range(len(self._connections)) if i not in replied]
+        return sorted(matches, key=lambda x: x[1], reverse=True)[:top_k], missing_shards
+
+    def reset(self) -> None:
+        """
+        Resets the engines of all shards before processing a new sequence of audio.
+        """
+
+        for i, connection in enumerate(self._connections):
+            if self._is_connected[i]:
+                try:
+                    connection.send(('reset',))
+                except OSError:
+                    self._is_connected[i] = False
+
+    def delete(self) -> None:
+        """
+        Closes the connections to the shards.
+        """
+
+        for connection in self._connections:
+            try:
+                connection.send(('close',))
+            except OSError:
+                pass
+            connection.close()
+
+
+__all__ = [
+    'EagleShardCoordinator',
+    'EagleShardServer',
+]
@@ -14,7 +14,7 @@ import shutil
 
 import setuptools
 
-INCLUDE_FILES = ('../../LICENSE', '__init__.py', '_factory.py', '_eagle.py', '_util.py')
+INCLUDE_FILES = ('../../LICENSE', '__init__.py', '_factory.py', '_eagle.py', '_sharded.py', '_util.py')
 INCLUDE_LIBS = ('common', 'jetson', 'linux', 'mac', 'raspberry-pi', 'windows')
 
 os.system('git clean -dfx')
@@ -13,13 +13,15 @@ import argparse
 import os
 import struct
 import sys
+import threading
 import unittest
 import wave
 from time import perf_counter
-from typing import Sequence
+from typing import List, Sequence
 
 from _eagle import (
     Eagle,
+    EagleProfile,
     EagleProfiler)
 from _util import default_library_path, default_model_path
 
@@ -98,6 +100,68 @@ class EaglePerformanceTestCase(unittest.TestCase):
         print("Average recognizer performance: %s seconds" % avg_perf)
         self.assertLess(avg_perf, self.recognizer_performance_threshold_sec)
 
+    def test_performance_recognizer_threads(self) -> None:
+        eagle_profiler = EagleProfiler(
+            access_key=self.access_key,
+            model_path=default_model_path('../..'),
+            library_path=default_library_path('../..'))
+
+        for path in self.ENROLL_PATHS:
+            pcm = self.load_wav_resource(path)
+            _ = eagle_profiler.enroll(pcm)
+
+        profile = eagle_profiler.export().to_bytes()
+        eagle_profiler.delete()
+
+        pcm = self.load_wav_resource(self.TEST_PATH)
+
+        def run(eagle: Eagle, results: List[List[Sequence[float]]], index: int) -> None:
+            num_frames = len(pcm) // eagle.frame_length
+            scores = list()
+            for _ in range(self.num_test_iterations):
+                eagle.reset()
+                for n in range(num_frames):
+                    scores.append(eagle.process(pcm=pcm[n * eagle.frame_length:(n + 1) * eagle.frame_length]))
+            results[index] = scores
+
+        gil_enabled = getattr(sys, '_is_gil_enabled', lambda: True)()
+        print("GIL enabled: %s" % gil_enabled)
+
+        num_threads = 1
+        reference_scores = None
+        single_thread_sec = None
+        while num_threads <= (os.cpu_count() or 1):
+            eagles = [Eagle(
+                access_key=self.access_key,
+                model_path=default_model_path('../..'),
+                library_path=default_library_path('../..'),
+                speaker_profiles=[EagleProfile.from_bytes(profile)]) for _ in range(num_threads)]
+            results = [list() for _ in range(num_threads)]
+            threads = [threading.Thread(target=run, args=(eagles[i], results, i)) for i in range(num_threads)]
+
+            start = perf_counter()
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+            elapsed_sec = perf_counter() - start
+
+            for eagle in eagles:
+                eagle.delete()
+
+            if reference_scores is None:
+                reference_scores = results[0]
+                single_thread_sec = elapsed_sec
+
+            # every thread owns its instance, so concurrency must not change any of the scores
+            for scores in results:
+                self.assertEqual(scores, reference_scores)
+
+            print("Recognizer throughput with %d thread(s): %.2fx of a single thread" % (
+                num_threads,
+                num_threads * single_thread_sec / elapsed_sec))
+            num_threads *= 2
+
 
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
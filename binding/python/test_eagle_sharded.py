@@ -0,0 +1,234 @@
+#
+#    Copyright 2023 Picovoice Inc.
+#
+#    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+#    file accompanying this source.
+#
+#    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+#    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+#    specific language governing permissions and limitations under the License.
+#
+
+import argparse
+import importlib.util
+import multiprocessing
+import os
+import struct
+import sys
+import time
+import unittest
+import wave
+from multiprocessing.connection import Listener
+from typing import Sequence
+
+from _util import default_library_path, default_model_path
+
+AUTHKEY = b'eagle-test'
+
+
+def load_package():
+    # the binding's modules use relative imports, so this directory is loaded as the package it is installed as
+    directory = os.path.dirname(os.path.abspath(__file__))
+    spec = importlib.util.spec_from_file_location(
+        'pveagle',
+        os.path.join(directory, '__init__.py'),
+        submodule_search_locations=[directory])
+    package = importlib.util.module_from_spec(spec)
+    sys.modules['pveagle'] = package
+    spec.loader.exec_module(package)
+    return package
+
+
+pveagle = load_package()
+
+
+def run_shard(access_key: str, speaker_ids: Sequence[str], profiles: Sequence[bytes], address_pipe) -> None:
+    server = pveagle.EagleShardServer(
+        access_key=access_key,
+        model_path=default_model_path('../..'),
+        library_path=default_library_path('../..'),
+        speaker_ids=speaker_ids,
+        speaker_profiles=[pveagle.EagleProfile.from_bytes(profile) for profile in profiles],
+        authkey=AUTHKEY)
+    address_pipe.send(server.address)
+    server.serve()
+
+
+def run_failing_shard(access_key: str, speaker_ids: Sequence[str], profiles: Sequence[bytes], address_pipe) -> None:
+    server = pveagle.EagleShardServer(
+        access_key=access_key,
+        model_path=default_model_path('../..'),
+        library_path=default_library_path('../..'),
+        speaker_ids=speaker_ids,
+        speaker_profiles=[pveagle.EagleProfile.from_bytes(profile) for profile in profiles],
+        authkey=AUTHKEY)
+
+    # every other frame fails in the engine
+    process = server._eagle.process
+    num_calls = [0]
+
+    def failing_process(pcm: Sequence[int]) -> Sequence[float]:
+        num_calls[0] += 1
+        if num_calls[0] % 2 == 1:
+            raise pveagle.EagleRuntimeError("injected failure")
+        return process(pcm)
+
+    server._eagle.process = failing_process
+    address_pipe.send(server.address)
+    server.serve()
+
+
+def run_stalled_shard(address_pipe) -> None:
+    with Listener(('localhost', 0), authkey=AUTHKEY) as listener:
+        address_pipe.send(listener.address)
+        with listener.accept():
+            time.sleep(3600)
+
+
+class EagleShardedTestCase(unittest.TestCase):
+    ENROLL_PATHS = [
+        os.path.join(os.path.dirname(__file__), '../../resources/audio_samples/speaker_1_utt_1.wav'),
+        os.path.join(os.path.dirname(__file__), '../../resources/audio_samples/speaker_1_utt_2.wav')]
+    TEST_PATH = os.path.join(os.path.dirname(__file__), '../../resources/audio_samples/speaker_1_test_utt.wav')
+    IMPOSTER_PATH = os.path.join(os.path.dirname(__file__), '../../resources/audio_samples/speaker_2_test_utt.wav')
+    access_key: str
+
+    @staticmethod
+    def load_wav_resource(path: str) -> Sequence[int]:
+        with wave.open(path, 'rb') as f:
+            buffer = f.readframes(f.getnframes())
+            return struct.unpack('%dh' % f.getnframes(), buffer)
+
+    @classmethod
+    def enroll(cls, paths: Sequence[str]) -> bytes:
+        eagle_profiler = pveagle.EagleProfiler(
+            access_key=cls.access_key,
+            model_path=default_model_path('../..'),
+            library_path=default_library_path('../..'))
+        for path in paths:
+            _ = eagle_profiler.enroll(cls.load_wav_resource(path))
+        profile = eagle_profiler.export().to_bytes()
+        eagle_profiler.delete()
+        return profile
+
+    @classmethod
+    def start_process(cls, target, *args):
+        parent_pipe, child_pipe = multiprocessing.Pipe()
+        process = multiprocessing.Process(target=target, args=(*args, child_pipe), daemon=True)
+        process.start()
+        cls.processes.append(process)
+        return parent_pipe.recv()
+
+    @classmethod
+    def setUpClass(cls) -> None:
+        cls.processes = []
+        speaker_1 = cls.enroll(cls.ENROLL_PATHS)
+        speaker_2 = cls.enroll([cls.IMPOSTER_PATH])
+
+        eagle = pveagle.Eagle(
+            access_key=cls.access_key,
+            model_path=default_model_path('../..'),
+            library_path=default_library_path('../..'),
+            speaker_profiles=[pveagle.EagleProfile.from_bytes(speaker_1)])
+        cls.frame_length = eagle.frame_length
+        eagle.delete()
+
+        # each node holds a different part of the catalogue
+        cls.shard_addresses = [
+            cls.start_process(run_shard, cls.access_key, ['speaker_1'], [speaker_1]),
+            cls.start_process(run_shard, cls.access_key, ['speaker_2'], [speaker_2]),
+        ]
+        cls.failing_address = cls.start_process(run_failing_shard, cls.access_key, ['speaker_1'], [speaker_1])
+        cls.stalled_address = cls.start_process(run_stalled_shard)
+
+    @classmethod
+    def tearDownClass(cls) -> None:
+        for process in cls.processes:
+            process.terminate()
+            process.join()
+
+    def process_file(self, coordinator: pveagle.EagleShardCoordinator, path: str, top_k: int):
+        pcm = self.load_wav_resource(path)
+        results = []
+        for i in range(len(pcm) // self.frame_length):
+            frame = pcm[i * self.frame_length:(i + 1) * self.frame_length]
+            results.append(coordinator.process(frame, top_k=top_k))
+        return results
+
+    def test_sharded_identification(self) -> None:
+        coordinator = pveagle.EagleShardCoordinator(
+            self.shard_addresses,
+            authkey=AUTHKEY,
+            frame_length=self.frame_length,
+            timeout_sec=10.0)
+        results = self.process_file(coordinator, self.TEST_PATH, top_k=2)
+        coordinator.delete()
+
+        for matches, missing_shards in results:
+            self.assertEqual(missing_shards, [])
+            self.assertEqual(sorted(speaker_id for speaker_id, _ in matches), ['speaker_1', 'speaker_2'])
+            self.assertGreaterEqual(matches[0][1], matches[1][1])
+
+        best_speaker_id, best_score = max((matches[0] for matches, _ in results), key=lambda x: x[1])
+        self.assertEqual(best_speaker_id, 'speaker_1')
+        self.assertGreater(best_score, 0.5)
+
+    def test_partial_result_timeout(self) -> None:
+        timeout_sec = 0.5
+        coordinator = pveagle.EagleShardCoordinator(
+            [self.shard_addresses[0], self.stalled_address],
+            authkey=AUTHKEY,
+            frame_length=self.frame_length,
+            timeout_sec=timeout_sec)
+        pcm = self.load_wav_resource(self.TEST_PATH)
+
+        start = time.monotonic()
+        matches, missing_shards = coordinator.process(pcm[:self.frame_length], top_k=5)
+        elapsed_sec = time.monotonic() - start
+        coordinator.delete()
+
+        self.assertEqual(missing_shards, [1])
+        self.assertEqual([speaker_id for speaker_id, _ in matches], ['speaker_1'])
+        self.assertLess(elapsed_sec, timeout_sec * 4)
+
+    def test_invalid_frame_length(self) -> None:
+        coordinator = pveagle.EagleShardCoordinator(
+            self.shard_addresses,
+            authkey=AUTHKEY,
+            frame_length=self.frame_length,
+            timeout_sec=10.0)
+        pcm = self.load_wav_resource(self.TEST_PATH)
+
+        with self.assertRaises(pveagle.EagleInvalidArgumentError):
+            coordinator.process(pcm[:self.frame_length - 1])
+        matches, missing_shards = coordinator.process(pcm[:self.frame_length], top_k=2)
+        coordinator.delete()
+
+        self.assertEqual(missing_shards, [])
+        self.assertEqual(len(matches), 2)
+
+    def test_shard_error(self) -> None:
+        coordinator = pveagle.EagleShardCoordinator(
+            [self.shard_addresses[1], self.failing_address],
+            authkey=AUTHKEY,
+            frame_length=self.frame_length,
+            timeout_sec=10.0)
+        pcm = self.load_wav_resource(self.TEST_PATH)
+        frame = pcm[:self.frame_length]
+
+        with self.assertRaises(pveagle.EagleRuntimeError):
+            coordinator.process(frame, top_k=2)
+        matches, missing_shards = coordinator.process(frame, top_k=2)
+        coordinator.delete()
+
+        self.assertEqual(missing_shards, [])
+        self.assertEqual(sorted(speaker_id for speaker_id, _ in matches), ['speaker_1', 'speaker_2'])
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--access-key', required=True)
+    args = parser.parse_args()
+
+    EagleShardedTestCase.access_key = args.access_key
+    unittest.main(argv=sys.argv[:1])
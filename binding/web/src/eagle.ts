@@ -25,7 +25,13 @@ import {
 
 import { simd } from 'wasm-feature-detect';
 
-import { EagleModel, EagleProfile, EagleProfilerEnrollResult } from './types';
+import {
+  EagleModel,
+  EagleProcessFramesOptions,
+  EagleProfile,
+  EagleProfilerEnrollResult,
+  EagleScoreMatrix,
+} from './types';
 
 /**
  * WebAssembly function types
@@ -114,6 +120,7 @@ type EagleWasmOutput = EagleBaseWasmOutput & {
 
 const PV_STATUS_SUCCESS = 10000;
 const MAX_PCM_LENGTH_SEC = 60 * 15;
+const DEFAULT_CHUNK_FRAMES = 256;
 
 class EagleBase {
   protected readonly _pvStatusToString: pv_status_to_string_type;
@@ -837,6 +844,120 @@ export class Eagle extends EagleBase {
     });
   }
 
+  /**
+   * Processes consecutive frames of audio, e.g. a whole recording, and returns the scores of every frame.
+   * The audio is copied into the engine a chunk of frames at a time and the engine is not released to other calls
+   * until all frames are processed, which avoids the per-frame overhead of `.process()`. Trailing samples that do not
+   * fill a frame are ignored.
+   *
+   * @param pcm Audio samples. The incoming audio needs to have a sample rate equal to `.sampleRate` and be 16-bit
+   * linearly-encoded. Eagle operates on single-channel audio.
+   * @param options Processing options.
+   * @param options.chunkFrames Number of frames processed per chunk. Defaults to 256.
+   * @param options.onProgress Called after every chunk with the fraction of frames processed so far.
+   *
+   * @return The scores of every speaker profile for every frame.
+   */
+  public async processFrames(
+    pcm: Int16Array,
+    options: EagleProcessFramesOptions = {}
+  ): Promise<EagleScoreMatrix> {
+    if (!(pcm instanceof Int16Array)) {
+      throw new Error("The argument 'pcm' must be provided as an Int16Array");
+    }
+
+    const { chunkFrames = DEFAULT_CHUNK_FRAMES, onProgress } = options;
+    if (!Number.isInteger(chunkFrames) || chunkFrames <= 0) {
+      throw new Error("The option 'chunkFrames' must be a positive integer");
+    }
+
+    const frameLength = Eagle._frameLength;
+    const numSpeakers = this._numSpeakers;
+    const numFrames = Math.floor(pcm.length / frameLength);
+    const scores = new Float32Array(numFrames * numSpeakers);
+
+    return new Promise<EagleScoreMatrix>((resolve, reject) => {
+      this._functionMutex
+        .runExclusive(async () => {
+          if (this._wasmMemory === undefined) {
+            throw new Error('Attempted to call `.processFrames` after release');
+          }
+
+          const maxChunkFrames = Math.min(chunkFrames, numFrames);
+          if (maxChunkFrames === 0) {
+            return { numFrames, numSpeakers, scores };
+          }
+
+          const pcmAddress = await this._alignedAlloc(
+            Int16Array.BYTES_PER_ELEMENT,
+            maxChunkFrames * frameLength * Int16Array.BYTES_PER_ELEMENT
+          );
+          if (pcmAddress === 0) {
+            throw new Error('malloc failed: Cannot allocate memory');
+          }
+          const scoresAddress = await this._alignedAlloc(
+            Float32Array.BYTES_PER_ELEMENT,
+            maxChunkFrames * numSpeakers * Float32Array.BYTES_PER_ELEMENT
+          );
+          if (scoresAddress === 0) {
+            await this._pvFree(pcmAddress);
+            throw new Error('malloc failed: Cannot allocate memory');
+          }
+
+          try {
+            for (let start = 0; start < numFrames; start += maxChunkFrames) {
+              const end = Math.min(start + maxChunkFrames, numFrames);
+
+              // the memory may have grown since the last chunk, so views are created on every use
+              new Int16Array(this._wasmMemory.buffer).set(
+                pcm.subarray(start * frameLength, end * frameLength),
+                pcmAddress / Int16Array.BYTES_PER_ELEMENT
+              );
+
+              for (let i = 0; i < end - start; i++) {
+                const status = await this._pvEagleProcess(
+                  this._objectAddress,
+                  pcmAddress + i * frameLength * Int16Array.BYTES_PER_ELEMENT,
+                  scoresAddress + i * numSpeakers * Float32Array.BYTES_PER_ELEMENT
+                );
+                if (status !== PV_STATUS_SUCCESS) {
+                  throw new Error(
+                    `process failed with status ${arrayBufferToStringAtIndex(
+                      new Uint8Array(this._wasmMemory.buffer),
+                      await this._pvStatusToString(status)
+                    )}`
+                  );
+                }
+              }
+
+              scores.set(
+                new Float32Array(
+                  this._wasmMemory.buffer,
+                  scoresAddress,
+                  (end - start) * numSpeakers
+                ),
+                start * numSpeakers
+              );
+              if (onProgress) {
+                onProgress(end / numFrames);
+              }
+            }
+          } finally {
+            await this._pvFree(pcmAddress);
+            await this._pvFree(scoresAddress);
+          }
+
+          return { numFrames, numSpeakers, scores };
+        })
+        .then((result: EagleScoreMatrix) => {
+          resolve(result);
+        })
+        .catch((error: any) => {
+          reject(error);
+        });
+    });
+  }
+
   /**
    * Resets the internal state of the engine.
    * It is best to call before processing a new sequence of audio (e.g. a new voice interaction).
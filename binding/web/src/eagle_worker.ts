@@ -13,6 +13,9 @@ import PvWorker from 'web-worker:./eagle_worker_handler.ts';
 
 import {
   EagleModel,
+  EagleProcessFramesOptions,
+  EagleScoreMatrix,
+  EagleWorkerProcessFileResponse,
   EagleWorkerProcessResponse,
   EagleWorkerInitResponse,
   EagleWorkerReleaseResponse,
@@ -190,6 +193,71 @@ export class EagleWorker {
     return returnPromise;
   }
 
+  /**
+   * Scores a recording, e.g. an uploaded file, faster than real time. Encoded audio is decoded by the browser at
+   * `.sampleRate`; an `AudioBuffer` at any sample rate is resampled on the worker thread. The audio is mixed down to
+   * mono and processed in chunks of frames on the worker, starting from a reset engine, so only the decoded samples
+   * and the resulting scores cross the thread boundary.
+   *
+   * @param audio Encoded audio in a format supported by the browser, or decoded audio.
+   * @param options Processing options.
+   * @param options.chunkFrames Number of frames processed per chunk. Defaults to 256.
+   * @param options.onProgress Called after every chunk with the fraction of frames processed so far.
+   *
+   * @return The scores of every speaker profile for every frame.
+   */
+  public async processFile(
+    audio: Blob | ArrayBuffer | AudioBuffer,
+    options: EagleProcessFramesOptions = {}
+  ): Promise<EagleScoreMatrix> {
+    const audioBuffer =
+      audio instanceof AudioBuffer
+        ? audio
+        : await EagleWorker._decodeAudio(audio, this._sampleRate);
+
+    const channels: Float32Array[] = [];
+    for (let i = 0; i < audioBuffer.numberOfChannels; i++) {
+      channels.push(audioBuffer.getChannelData(i).slice());
+    }
+
+    const returnPromise: Promise<EagleScoreMatrix> = new Promise(
+      (resolve, reject) => {
+        this._worker.onmessage = (
+          event: MessageEvent<EagleWorkerProcessFileResponse>
+        ): void => {
+          switch (event.data.command) {
+            case 'progress':
+              if (options.onProgress) {
+                options.onProgress(event.data.progress);
+              }
+              break;
+            case 'ok':
+              resolve(event.data.result);
+              break;
+            case 'failed':
+            case 'error':
+              reject(event.data.message);
+              break;
+            default:
+              // @ts-ignore
+              reject(`Unrecognized command: ${event.data.command}`);
+          }
+        };
+      }
+    );
+    this._worker.postMessage(
+      {
+        command: 'processFile',
+        channels: channels,
+        sampleRate: audioBuffer.sampleRate,
+        chunkFrames: options.chunkFrames,
+      },
+      channels.map(channel => channel.buffer)
+    );
+
+    return returnPromise;
+  }
+
   /**
    * Resets the internal state of the engine.
    * It is best to call before processing a new sequence of audio (e.g. a new voice interaction).
@@ -257,4 +325,17 @@ export class EagleWorker {
   public terminate(): void {
     this._worker.terminate();
   }
+
+  private static async _decodeAudio(
+    audio: Blob | ArrayBuffer,
+    sampleRate: number
+  ): Promise<AudioBuffer> {
+    // `decodeAudioData` detaches its argument, so the caller's buffer is copied
+    const data =
+      audio instanceof Blob ? await audio.arrayBuffer() : audio.slice(0);
+    // decoding is not available on workers; the browser decodes off the main thread and resamples to the rate of the
+    // context
+    const context = new OfflineAudioContext(1, 1, sampleRate);
+    return context.decodeAudioData(data);
+  }
 }
@@ -11,8 +11,10 @@
 /// <reference lib="webworker" />
 
 import { Eagle } from './eagle';
+import { toEaglePcm } from './resampler';
 import {
   EagleWorkerProcessRequest,
+  EagleWorkerProcessFileRequest,
   EagleWorkerInitRequest,
   EagleWorkerRequest,
 } from './types';
@@ -71,6 +73,43 @@ const processRequest = async (
   }
 };
 
+const processFileRequest = async (
+  request: EagleWorkerProcessFileRequest
+): Promise<any> => {
+  if (eagle === null) {
+    return {
+      command: 'error',
+      message: 'Eagle has not been initialized',
+    };
+  }
+  try {
+    const pcm = toEaglePcm(
+      request.channels,
+      request.sampleRate,
+      eagle.sampleRate
+    );
+    await eagle.reset();
+    const result = await eagle.processFrames(pcm, {
+      chunkFrames: request.chunkFrames,
+      onProgress: (progress: number) => {
+        self.postMessage({
+          command: 'progress',
+          progress,
+        });
+      },
+    });
+    return {
+      command: 'ok',
+      result,
+    };
+  } catch (e: any) {
+    return {
+      command: 'error',
+      message: e.message,
+    };
+  }
+};
+
 const resetRequest = async (): Promise<any> => {
   if (eagle === null) {
     return {
@@ -115,6 +154,14 @@ self.onmessage = async function (
     case 'process':
       self.postMessage(await processRequest(event.data));
       break;
+    case 'processFile': {
+      const response = await processFileRequest(event.data);
+      self.postMessage(
+        response,
+        response.command === 'ok' ? [response.result.scores.buffer] : []
+      );
+      break;
+    }
     case 'reset':
       self.postMessage(await resetRequest());
       break;
@@ -4,6 +4,7 @@ import { EagleWorker } from './eagle_worker';
 
 import {
   EagleModel,
+  EagleProcessFramesOptions,
   EagleProfile,
   EagleProfilerEnrollFeedback,
   EagleProfilerEnrollResult,
@@ -20,9 +21,12 @@ import {
   EagleProfilerWorkerResetRequest,
   EagleProfilerWorkerResetResponse,
   EagleProfilerWorkerResponse,
+  EagleScoreMatrix,
   EagleWorkerFailureResponse,
   EagleWorkerInitRequest,
   EagleWorkerInitResponse,
+  EagleWorkerProcessFileRequest,
+  EagleWorkerProcessFileResponse,
   EagleWorkerProcessRequest,
   EagleWorkerProcessResponse,
   EagleWorkerReleaseRequest,
@@ -48,6 +52,7 @@ EagleProfilerWorker.setWasmSimd(eagleWasmSimd);
 export {
   Eagle,
   EagleModel,
+  EagleProcessFramesOptions,
   EagleProfile,
   EagleProfiler,
   EagleProfilerEnrollFeedback,
@@ -66,10 +71,13 @@ export {
   EagleProfilerWorkerResetRequest,
   EagleProfilerWorkerResetResponse,
   EagleProfilerWorkerResponse,
+  EagleScoreMatrix,
   EagleWorker,
   EagleWorkerFailureResponse,
   EagleWorkerInitRequest,
   EagleWorkerInitResponse,
+  EagleWorkerProcessFileRequest,
+  EagleWorkerProcessFileResponse,
   EagleWorkerProcessRequest,
   EagleWorkerProcessResponse,
   EagleWorkerReleaseRequest,
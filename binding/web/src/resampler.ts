@@ -0,0 +1,134 @@
+/*
+  Copyright 2023 Picovoice Inc.
+
+  You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+  file accompanying this source.
+
+  Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+  an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+  specific language governing permissions and limitations under the License.
+*/
+
+const ZERO_CROSSINGS = 8;
+
+/**
+ * Hann-windowed sinc, truncated after `ZERO_CROSSINGS` zero crossings on either side.
+ */
+function kernel(x: number): number {
+  if (x === 0) {
+    return 1;
+  }
+  if (Math.abs(x) >= ZERO_CROSSINGS) {
+    return 0;
+  }
+  const sinc = Math.sin(Math.PI * x) / (Math.PI * x);
+  return sinc * (0.5 + 0.5 * Math.cos((Math.PI * x) / ZERO_CROSSINGS));
+}
+
+function gcd(a: number, b: number): number {
+  while (b !== 0) {
+    [a, b] = [b, a % b];
+  }
+  return a;
+}
+
+function downmix(channels: Float32Array[]): Float32Array {
+  if (channels.length === 1) {
+    return channels[0];
+  }
+
+  const length = Math.min(...channels.map(channel => channel.length));
+  const mono = new Float32Array(length);
+  for (const channel of channels) {
+    for (let i = 0; i < length; i++) {
+      mono[i] += channel[i];
+    }
+  }
+  for (let i = 0; i < length; i++) {
+    mono[i] /= channels.length;
+  }
+  return mono;
+}
+
+function resample(
+  input: Float32Array,
+  inputSampleRate: number,
+  outputSampleRate: number
+): Float32Array {
+  if (inputSampleRate === outputSampleRate) {
+    return input;
+  }
+
+  // output sample `n` lies at input position `n * down / up`; its offset from the preceding input sample repeats every
+  // `up` outputs, so one filter per offset is computed up front
+  const divisor = gcd(inputSampleRate, outputSampleRate);
+  const up = outputSampleRate / divisor;
+  const down = inputSampleRate / divisor;
+  // when downsampling, the kernel is stretched so that its cutoff is at the output Nyquist frequency
+  const scale = Math.min(1, up / down);
+  const numTaps = 2 * Math.ceil(ZERO_CROSSINGS / scale);
+  const halfTaps = numTaps / 2;
+
+  const filters = new Float32Array(up * numTaps);
+  for (let phase = 0; phase < up; phase++) {
+    for (let j = 0; j < numTaps; j++) {
+      filters[phase * numTaps + j] =
+        kernel((phase / up + halfTaps - 1 - j) * scale) * scale;
+    }
+  }
+
+  const output = new Float32Array(Math.floor((input.length * up) / down));
+  for (let n = 0; n < output.length; n++) {
+    const position = n * down;
+    const base = Math.floor(position / up);
+    const filter = (position - base * up) * numTaps;
+    const first = base - halfTaps + 1;
+
+    let sum = 0;
+    if (first >= 0 && first + numTaps <= input.length) {
+      for (let j = 0; j < numTaps; j++) {
+        sum += input[first + j] * filters[filter + j];
+      }
+    } else {
+      for (let j = 0; j < numTaps; j++) {
+        const k = first + j;
+        if (k >= 0 && k < input.length) {
+          sum += input[k] * filters[filter + j];
+        }
+      }
+    }
+    output[n] = sum;
+  }
+  return output;
+}
+
+/**
+ * Converts decoded audio into the input expected by Eagle: the channels are mixed down to mono, resampled with a
+ * windowed-sinc filter and converted to 16-bit linear PCM.
+ *
+ * @param channels Samples of every channel in [-1, 1], as returned by `AudioBuffer.getChannelData()`.
+ * @param inputSampleRate Sample rate of `channels`.
+ * @param outputSampleRate Sample rate required by Eagle.
+ *
+ * @return Single-channel 16-bit audio at `outputSampleRate`.
+ */
+export function toEaglePcm(
+  channels: Float32Array[],
+  inputSampleRate: number,
+  outputSampleRate: number
+): Int16Array {
+  if (channels.length === 0) {
+    throw new Error('Audio must have at least one channel');
+  }
+
+  const audio = resample(
+    downmix(channels),
+    Math.round(inputSampleRate),
+    outputSampleRate
+  );
+  const pcm = new Int16Array(audio.length);
+  for (let i = 0; i < audio.length; i++) {
+    pcm[i] = Math.max(-32768, Math.min(32767, Math.round(audio[i] * 32768)));
+  }
+  return pcm;
+}
@@ -34,6 +34,20 @@ export type EagleProfilerEnrollResult = {
   percentage: number;
 };
 
+export type EagleProcessFramesOptions = {
+  /** Number of frames copied into the engine and processed per chunk. */
+  chunkFrames?: number;
+  /** Called after every chunk with the fraction of frames processed so far, in (0, 1]. */
+  onProgress?: (progress: number) => void;
+};
+
+export type EagleScoreMatrix = {
+  numFrames: number;
+  numSpeakers: number;
+  /** Scores in frame-major order: the score of speaker `s` for frame `f` is `scores[f * numSpeakers + s]`. */
+  scores: Float32Array;
+};
+
 export type EagleProfilerWorkerInitRequest = {
   command: 'init';
   accessKey: string;
@@ -127,6 +141,13 @@ export type EagleWorkerProcessRequest = {
   inputFrame: Int16Array;
 };
 
+export type EagleWorkerProcessFileRequest = {
+  command: 'processFile';
+  channels: Float32Array[];
+  sampleRate: number;
+  chunkFrames?: number;
+};
+
 export type EagleWorkerResetRequest = {
   command: 'reset';
 };
@@ -138,6 +159,7 @@ export type EagleWorkerReleaseRequest = {
 export type EagleWorkerRequest =
   | EagleWorkerInitRequest
   | EagleWorkerProcessRequest
+  | EagleWorkerProcessFileRequest
   | EagleWorkerResetRequest
   | EagleWorkerReleaseRequest;
 
@@ -162,6 +184,17 @@ export type EagleWorkerProcessResponse =
       scores: number[];
     };
 
+export type EagleWorkerProcessFileResponse =
+  | EagleWorkerFailureResponse
+  | {
+      command: 'progress';
+      progress: number;
+    }
+  | {
+      command: 'ok';
+      result: EagleScoreMatrix;
+    };
+
 export type EagleWorkerResetResponse =
   | EagleWorkerFailureResponse
   | {
@@ -177,5 +210,6 @@ export type EagleWorkerReleaseResponse =
 export type EagleWorkerResponse =
   | EagleWorkerInitResponse
   | EagleWorkerProcessResponse
+  | EagleWorkerProcessFileResponse
   | EagleWorkerResetResponse
   | EagleWorkerReleaseResponse;
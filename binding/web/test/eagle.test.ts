@@ -378,6 +378,78 @@ describe('Eagle', function () {
     );
   });
 
+  it('eagle process frames', () => {
+    cy.getFramesFromFile('audio_samples/speaker_1_test_utt.wav').then(
+      async testPcm => {
+        try {
+          const eagle = await Eagle.create(
+            ACCESS_KEY,
+            {
+              publicPath: '/test/eagle_params.pv',
+              forceWrite: true,
+            },
+            testProfile
+          );
+          const scores = await getScores(eagle, testPcm);
+          await eagle.reset();
+
+          const progress: number[] = [];
+          const result = await eagle.processFrames(testPcm, {
+            chunkFrames: 10,
+            onProgress: p => progress.push(p),
+          });
+
+          expect(result.numFrames).to.be.eq(scores.length);
+          expect(result.numSpeakers).to.be.eq(1);
+          expect(Array.from(result.scores)).to.be.deep.eq(scores);
+          expect(progress.length).to.be.eq(Math.ceil(scores.length / 10));
+          expect(progress[progress.length - 1]).to.be.eq(1);
+          await eagle.release();
+        } catch (e) {
+          expect(e).to.be.undefined;
+        }
+      }
+    );
+  });
+
+  it('eagle process file (worker)', () => {
+    cy.getFramesFromFile('audio_samples/speaker_1_test_utt.wav').then(
+      async testPcm => {
+        cy.fixture('audio_samples/speaker_1_test_utt.wav', 'base64')
+          .then(Cypress.Blob.base64StringToBlob)
+          .then(async testFile => {
+            try {
+              const eagle = await EagleWorker.create(
+                ACCESS_KEY,
+                {
+                  publicPath: '/test/eagle_params.pv',
+                  forceWrite: true,
+                },
+                testProfile
+              );
+              const scores = await getScores(eagle, testPcm);
+
+              let lastProgress = 0;
+              const result = await eagle.processFile(testFile, {
+                onProgress: p => {
+                  expect(p).to.be.gt(lastProgress);
+                  lastProgress = p;
+                },
+              });
+
+              expect(result.numFrames).to.be.eq(scores.length);
+              expect(Array.from(result.scores)).to.be.deep.eq(scores);
+              expect(lastProgress).to.be.eq(1);
+              await eagle.release();
+              await eagle.terminate();
+            } catch (e) {
+              expect(e).to.be.undefined;
+            }
+          });
+      }
+    );
+  });
+
   it('eagle process imposter', () => {
     cy.getFramesFromFile('audio_samples/speaker_2_test_utt.wav').then(
       async testPcm => {
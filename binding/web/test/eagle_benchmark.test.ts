@@ -0,0 +1,212 @@
+import { simd } from 'wasm-feature-detect';
+
+import { Eagle, EagleProfiler, EagleProfilerWorker, EagleWorker } from '../';
+
+const ACCESS_KEY = Cypress.env('ACCESS_KEY');
+const NUM_TEST_ITERATIONS = Number(Cypress.env('NUM_TEST_ITERATIONS'));
+const BENCHMARK_OUTPUT_PATH =
+  Cypress.env('BENCHMARK_OUTPUT_PATH') || 'eagle_benchmark.json';
+
+const MODEL = {
+  publicPath: '/test/eagle_params.pv',
+  forceWrite: true,
+};
+
+type LatencyStats = {
+  count: number;
+  meanMs: number;
+  p50Ms: number;
+  p90Ms: number;
+  p99Ms: number;
+  maxMs: number;
+};
+
+function summarize(latenciesMs: number[]): LatencyStats {
+  const sorted = [...latenciesMs].sort((a, b) => a - b);
+  const percentile = (p: number): number =>
+    sorted[Math.max(0, Math.ceil((p / 100) * sorted.length) - 1)];
+
+  return {
+    count: sorted.length,
+    meanMs: sorted.reduce((a, b) => a + b, 0) / sorted.length,
+    p50Ms: percentile(50),
+    p90Ms: percentile(90),
+    p99Ms: percentile(99),
+    maxMs: sorted[sorted.length - 1],
+  };
+}
+
+// the bindings load the SIMD build whenever the browser supports it, so the non-SIMD variant is selected by pointing
+// the SIMD slot at the plain build
+const wasmBuilds = [Eagle, EagleWorker, EagleProfiler, EagleProfilerWorker].map(
+  (engine: any) => ({
+    engine,
+    wasm: engine._wasm,
+    wasmSimd: engine._wasmSimd,
+  })
+);
+
+function selectBuild(useSimd: boolean): void {
+  for (const { engine, wasm, wasmSimd } of wasmBuilds) {
+    engine._wasmSimd = useSimd ? wasmSimd : wasm;
+  }
+}
+
+// the memory of instances on a worker is not reachable from the main thread
+function wasmMemoryBytes(engine: any): number | null {
+  return engine._wasmMemory ? engine._wasmMemory.buffer.byteLength : null;
+}
+
+async function benchmarkVariant(
+  useWorker: boolean,
+  useSimd: boolean,
+  enrollPcm: Int16Array[],
+  testPcm: Int16Array
+): Promise<object> {
+  selectBuild(useSimd);
+
+  const profiler = useWorker
+    ? await EagleProfilerWorker.create(ACCESS_KEY, MODEL)
+    : await EagleProfiler.create(ACCESS_KEY, MODEL);
+
+  const enrollLatencies: number[] = [];
+  for (let i = 0; i < NUM_TEST_ITERATIONS + 1; i++) {
+    const start = performance.now();
+    await profiler.enroll(testPcm);
+    if (i > 0) {
+      enrollLatencies.push(performance.now() - start);
+    }
+  }
+
+  await profiler.reset();
+  for (const pcm of enrollPcm) {
+    await profiler.enroll(pcm);
+  }
+  const profile = await profiler.export();
+  const profilerMemoryBytes = wasmMemoryBytes(profiler);
+  await profiler.release();
+  if (profiler instanceof EagleProfilerWorker) {
+    profiler.terminate();
+  }
+
+  const eagle = useWorker
+    ? await EagleWorker.create(ACCESS_KEY, MODEL, profile)
+    : await Eagle.create(ACCESS_KEY, MODEL, profile);
+
+  const frames: Int16Array[] = [];
+  for (
+    let i = 0;
+    i < testPcm.length - eagle.frameLength + 1;
+    i += eagle.frameLength
+  ) {
+    frames.push(testPcm.slice(i, i + eagle.frameLength));
+  }
+
+  const processLatencies: number[] = [];
+  for (let i = 0; i < NUM_TEST_ITERATIONS + 1; i++) {
+    await eagle.reset();
+    for (const frame of frames) {
+      const start = performance.now();
+      await eagle.process(frame);
+      if (i > 0) {
+        processLatencies.push(performance.now() - start);
+      }
+    }
+  }
+
+  let messageRoundTrip: LatencyStats | null = null;
+  if (eagle instanceof EagleWorker) {
+    // a frame one sample short is rejected on the worker before it reaches the engine, which leaves the cost of
+    // posting a frame and receiving the reply
+    const shortFrame = new Int16Array(eagle.frameLength - 1);
+    const roundTripLatencies: number[] = [];
+    for (let i = 0; i < frames.length; i++) {
+      const start = performance.now();
+      try {
+        await eagle.process(shortFrame);
+      } catch (e) {
+        roundTripLatencies.push(performance.now() - start);
+      }
+    }
+    messageRoundTrip = summarize(roundTripLatencies);
+  }
+
+  const result = {
+    thread: useWorker ? 'worker' : 'main',
+    simd: useSimd,
+    version: eagle.version,
+    enroll: summarize(enrollLatencies),
+    process: summarize(processLatencies),
+    messageRoundTrip: messageRoundTrip,
+    wasmMemoryBytes: {
+      profiler: profilerMemoryBytes,
+      eagle: wasmMemoryBytes(eagle),
+    },
+  };
+
+  await eagle.release();
+  if (eagle instanceof EagleWorker) {
+    eagle.terminate();
+  }
+
+  return result;
+}
+
+describe('Eagle benchmark', () => {
+  Cypress.config('defaultCommandTimeout', 600000);
+
+  const report = {
+    timestamp: new Date().toISOString(),
+    userAgent: navigator.userAgent,
+    numTestIterations: NUM_TEST_ITERATIONS,
+    simdSupported: false,
+    variants: [] as object[],
+  };
+
+  before(async () => {
+    report.simdSupported = await simd();
+  });
+
+  for (const useSimd of [false, true]) {
+    for (const useWorker of [false, true]) {
+      const variant = `${useWorker ? 'worker' : 'main'}, ${
+        useSimd ? 'simd' : 'no simd'
+      }`;
+
+      it(`should benchmark (${variant})`, () => {
+        cy.getFramesFromFile('audio_samples/speaker_1_utt_1.wav').then(
+          async enrollPcm1 => {
+            cy.getFramesFromFile('audio_samples/speaker_1_utt_2.wav').then(
+              async enrollPcm2 => {
+                cy.getFramesFromFile(
+                  'audio_samples/speaker_1_test_utt.wav'
+                ).then(async testPcm => {
+                  if (useSimd && !report.simdSupported) {
+                    // eslint-disable-next-line no-console
+                    console.log(`SIMD is not supported, skipping (${variant})`);
+                    return;
+                  }
+
+                  const result = await benchmarkVariant(
+                    useWorker,
+                    useSimd,
+                    [enrollPcm1, enrollPcm2],
+                    testPcm
+                  );
+                  // eslint-disable-next-line no-console
+                  console.log(JSON.stringify(result));
+                  report.variants.push(result);
+                });
+              }
+            );
+          }
+        );
+      });
+    }
+  }
+
+  after(() => {
+    selectBuild(true);
+    cy.writeFile(BENCHMARK_OUTPUT_PATH, report);
+  });
+});
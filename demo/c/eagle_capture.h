@@ -0,0 +1,289 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef EAGLE_CAPTURE_H
+#define EAGLE_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Capture file for recording a live Eagle session and replaying it offline.
+ *
+ * The file starts with a header (magic `PVEC`, format version, sample rate and frame length) followed by a sequence of
+ * records. Each record starts with a one-byte type and the microseconds elapsed since the previous record:
+ * - `EAGLE_CAPTURE_RECORD_FRAME`: one frame of `frame_length` 16-bit samples, timestamped at arrival.
+ * - `EAGLE_CAPTURE_RECORD_RESET`: `pv_eagle_reset()` was called.
+ * - `EAGLE_CAPTURE_RECORD_PROFILES`: the engine was (re)created with a new set of speaker profiles, stored as a count
+ *   followed by size-prefixed profile blobs.
+ * - `EAGLE_CAPTURE_RECORD_SCORES`: the result of processing the preceding frame live, stored as the microseconds spent
+ *   in `pv_eagle_process()` and a count followed by the scores. It carries the timestamp of its frame.
+ *
+ * Version 1 files have no score records and can still be read.
+ *
+ * All integers are stored in the byte order of the capturing host.
+ */
+
+#define EAGLE_CAPTURE_MAGIC   ("PVEC")
+#define EAGLE_CAPTURE_VERSION (2)
+
+typedef enum {
+    EAGLE_CAPTURE_RECORD_FRAME = 0,
+    EAGLE_CAPTURE_RECORD_RESET,
+    EAGLE_CAPTURE_RECORD_PROFILES,
+    EAGLE_CAPTURE_RECORD_SCORES,
+} eagle_capture_record_type_t;
+
+typedef enum {
+    EAGLE_CAPTURE_READ_RECORD = 0,
+    EAGLE_CAPTURE_READ_END,
+    EAGLE_CAPTURE_READ_ERROR,
+} eagle_capture_read_status_t;
+
+typedef struct {
+    FILE *file;
+    int32_t sample_rate;
+    int32_t frame_length;
+    uint64_t last_timestamp_usec;
+    long record_offset;
+} eagle_capture_t;
+
+typedef struct {
+    eagle_capture_record_type_t type;
+    uint64_t timestamp_usec;
+    int16_t *pcm;
+    int32_t num_profiles;
+    void **profiles;
+    int32_t *profile_sizes;
+    uint32_t process_usec;
+    int32_t num_scores;
+    float *scores;
+} eagle_capture_record_t;
+
+/**
+ * Creates a capture file and writes its header.
+ *
+ * @return `true` on success.
+ */
+static inline bool eagle_capture_open_write(
+        eagle_capture_t *capture,
+        const char *path,
+        int32_t sample_rate,
+        int32_t frame_length) {
+    memset(capture, 0, sizeof(*capture));
+    capture->file = fopen(path, "wb");
+    if (!capture->file) {
+        return false;
+    }
+    capture->sample_rate = sample_rate;
+    capture->frame_length = frame_length;
+
+    const uint32_t version = EAGLE_CAPTURE_VERSION;
+    return (fwrite(EAGLE_CAPTURE_MAGIC, 4, 1, capture->file) == 1) &&
+           (fwrite(&version, sizeof(version), 1, capture->file) == 1) &&
+           (fwrite(&sample_rate, sizeof(sample_rate), 1, capture->file) == 1) &&
+           (fwrite(&frame_length, sizeof(frame_length), 1, capture->file) == 1);
+}
+
+/**
+ * Opens a capture file for replay and reads its header.
+ *
+ * @return `true` if the file is a capture of a supported version.
+ */
+static inline bool eagle_capture_open_read(eagle_capture_t *capture, const char *path) {
+    memset(capture, 0, sizeof(*capture));
+    capture->file = fopen(path, "rb");
+    if (!capture->file) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    return (fread(magic, 4, 1, capture->file) == 1) &&
+           (memcmp(magic, EAGLE_CAPTURE_MAGIC, 4) == 0) &&
+           (fread(&version, sizeof(version), 1, capture->file) == 1) &&
+           (version >= 1) && (version <= EAGLE_CAPTURE_VERSION) &&
+           (fread(&capture->sample_rate, sizeof(capture->sample_rate), 1, capture->file) == 1) &&
+           (fread(&capture->frame_length, sizeof(capture->frame_length), 1, capture->file) == 1) &&
+           (capture->frame_length > 0);
+}
+
+static inline void eagle_capture_close(eagle_capture_t *capture) {
+    if (capture->file) {
+        fclose(capture->file);
+        capture->file = NULL;
+    }
+}
+
+static inline bool eagle_capture_write_record_header(
+        eagle_capture_t *capture,
+        eagle_capture_record_type_t type,
+        uint64_t timestamp_usec) {
+    const uint8_t type_byte = (uint8_t) type;
+    const uint64_t delta = (timestamp_usec > capture->last_timestamp_usec) ?
+                                   (timestamp_usec - capture->last_timestamp_usec) :
+                                   0;
+    const uint32_t delta_usec = (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t) delta;
+    capture->last_timestamp_usec += delta_usec;
+
+    return (fwrite(&type_byte, sizeof(type_byte), 1, capture->file) == 1) &&
+           (fwrite(&delta_usec, sizeof(delta_usec), 1, capture->file) == 1);
+}
+
+/**
+ * Appends a frame of `frame_length` samples that arrived at `timestamp_usec`.
+ */
+static inline bool eagle_capture_write_frame(eagle_capture_t *capture, uint64_t timestamp_usec, const int16_t *pcm) {
+    return eagle_capture_write_record_header(capture, EAGLE_CAPTURE_RECORD_FRAME, timestamp_usec) &&
+           (fwrite(pcm, sizeof(int16_t), (size_t) capture->frame_length, capture->file) ==
+            (size_t) capture->frame_length);
+}
+
+static inline bool eagle_capture_write_reset(eagle_capture_t *capture, uint64_t timestamp_usec) {
+    return eagle_capture_write_record_header(capture, EAGLE_CAPTURE_RECORD_RESET, timestamp_usec);
+}
+
+static inline bool eagle_capture_write_profiles(
+        eagle_capture_t *capture,
+        uint64_t timestamp_usec,
+        int32_t num_profiles,
+        const void *const *profiles,
+        const int32_t *profile_sizes) {
+    if (!eagle_capture_write_record_header(capture, EAGLE_CAPTURE_RECORD_PROFILES, timestamp_usec) ||
+        (fwrite(&num_profiles, sizeof(num_profiles), 1, capture->file) != 1)) {
+        return false;
+    }
+    for (int32_t i = 0; i < num_profiles; i++) {
+        if ((fwrite(&profile_sizes[i], sizeof(int32_t), 1, capture->file) != 1) ||
+            (fwrite(profiles[i], 1, (size_t) profile_sizes[i], capture->file) != (size_t) profile_sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends the scores and the processing time of the frame written last, which arrived at `timestamp_usec`.
+ */
+static inline bool eagle_capture_write_scores(
+        eagle_capture_t *capture,
+        uint64_t timestamp_usec,
+        uint32_t process_usec,
+        int32_t num_scores,
+        const float *scores) {
+    return eagle_capture_write_record_header(capture, EAGLE_CAPTURE_RECORD_SCORES, timestamp_usec) &&
+           (fwrite(&process_usec, sizeof(process_usec), 1, capture->file) == 1) &&
+           (fwrite(&num_scores, sizeof(num_scores), 1, capture->file) == 1) &&
+           (fwrite(scores, sizeof(float), (size_t) num_scores, capture->file) == (size_t) num_scores);
+}
+
+/**
+ * Releases the buffers held by a record returned from `eagle_capture_read_record()`.
+ */
+static inline void eagle_capture_record_free(eagle_capture_record_t *record) {
+    free(record->pcm);
+    for (int32_t i = 0; i < record->num_profiles; i++) {
+        free(record->profiles[i]);
+    }
+    free(record->profiles);
+    free(record->profile_sizes);
+    free(record->scores);
+    memset(record, 0, sizeof(*record));
+}
+
+/**
+ * Reads the next record. The caller owns its buffers and releases them with `eagle_capture_record_free()`. The byte
+ * offset at which the record starts is left in `capture->record_offset`, so that an error can be located.
+ *
+ * @return `EAGLE_CAPTURE_READ_RECORD` if a complete record was read, `EAGLE_CAPTURE_READ_END` at the end of the file,
+ * or `EAGLE_CAPTURE_READ_ERROR` on a truncated record, a record of unknown type or a failed allocation.
+ */
+static inline eagle_capture_read_status_t eagle_capture_read_record(
+        eagle_capture_t *capture,
+        eagle_capture_record_t *record) {
+    memset(record, 0, sizeof(*record));
+    capture->record_offset = ftell(capture->file);
+
+    uint8_t type_byte = 0;
+    uint32_t delta_usec = 0;
+    if (fread(&type_byte, sizeof(type_byte), 1, capture->file) != 1) {
+        return ferror(capture->file) ? EAGLE_CAPTURE_READ_ERROR : EAGLE_CAPTURE_READ_END;
+    }
+    if (fread(&delta_usec, sizeof(delta_usec), 1, capture->file) != 1) {
+        return EAGLE_CAPTURE_READ_ERROR;
+    }
+    capture->last_timestamp_usec += delta_usec;
+    record->type = (eagle_capture_record_type_t) type_byte;
+    record->timestamp_usec = capture->last_timestamp_usec;
+
+    switch (record->type) {
+        case EAGLE_CAPTURE_RECORD_FRAME:
+            record->pcm = (int16_t *) malloc((size_t) capture->frame_length * sizeof(int16_t));
+            if (!record->pcm ||
+                (fread(record->pcm, sizeof(int16_t), (size_t) capture->frame_length, capture->file) !=
+                 (size_t) capture->frame_length)) {
+                eagle_capture_record_free(record);
+                return EAGLE_CAPTURE_READ_ERROR;
+            }
+            return EAGLE_CAPTURE_READ_RECORD;
+        case EAGLE_CAPTURE_RECORD_RESET:
+            return EAGLE_CAPTURE_READ_RECORD;
+        case EAGLE_CAPTURE_RECORD_PROFILES: {
+            int32_t num_profiles = 0;
+            if ((fread(&num_profiles, sizeof(num_profiles), 1, capture->file) != 1) || (num_profiles < 0)) {
+                return EAGLE_CAPTURE_READ_ERROR;
+            }
+            record->profiles = (void **) calloc((size_t) num_profiles + 1, sizeof(void *));
+            record->profile_sizes = (int32_t *) calloc((size_t) num_profiles + 1, sizeof(int32_t));
+            if (!record->profiles || !record->profile_sizes) {
+                eagle_capture_record_free(record);
+                return EAGLE_CAPTURE_READ_ERROR;
+            }
+            for (int32_t i = 0; i < num_profiles; i++) {
+                int32_t size = 0;
+                if ((fread(&size, sizeof(size), 1, capture->file) != 1) || (size < 0)) {
+                    eagle_capture_record_free(record);
+                    return EAGLE_CAPTURE_READ_ERROR;
+                }
+                record->profiles[i] = malloc((size_t) size + 1);
+                record->profile_sizes[i] = size;
+                record->num_profiles = i + 1;
+                if (!record->profiles[i] ||
+                    (fread(record->profiles[i], 1, (size_t) size, capture->file) != (size_t) size)) {
+                    eagle_capture_record_free(record);
+                    return EAGLE_CAPTURE_READ_ERROR;
+                }
+            }
+            return EAGLE_CAPTURE_READ_RECORD;
+        }
+        case EAGLE_CAPTURE_RECORD_SCORES:
+            if ((fread(&record->process_usec, sizeof(record->process_usec), 1, capture->file) != 1) ||
+                (fread(&record->num_scores, sizeof(record->num_scores), 1, capture->file) != 1) ||
+                (record->num_scores < 0)) {
+                return EAGLE_CAPTURE_READ_ERROR;
+            }
+            record->scores = (float *) malloc(((size_t) record->num_scores + 1) * sizeof(float));
+            if (!record->scores ||
+                (fread(record->scores, sizeof(float), (size_t) record->num_scores, capture->file) !=
+                 (size_t) record->num_scores)) {
+                eagle_capture_record_free(record);
+                return EAGLE_CAPTURE_READ_ERROR;
+            }
+            return EAGLE_CAPTURE_READ_RECORD;
+        default:
+            return EAGLE_CAPTURE_READ_ERROR;
+    }
+}
+
+#endif // EAGLE_CAPTURE_H
@@ -0,0 +1,409 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <getopt.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DR_WAV_IMPLEMENTATION
+
+#include "dr_wav.h"
+
+#include "pv_eagle.hpp"
+#include "pv_eagle_resources.hpp"
+
+#include "perf_counters.h"
+
+// Measures the latency distribution of `pv_eagle_process()` while co-located stressor threads compete for memory
+// bandwidth, the last-level cache or CPU time. Every engine configuration (number of enrolled speakers) is run once
+// without interference as a baseline and once per interference scenario, and the report shows how much each scenario
+// inflates the tail latency of each configuration. Where hardware counters are available, LLC and dTLB misses per frame
+// and IPC show whether the slowdown comes from memory or from losing the core.
+
+static struct option long_options[] = {
+        {"access_key",     required_argument, NULL, 'a'},
+        {"model_path",     required_argument, NULL, 'm'},
+        {"test",           required_argument, NULL, 't'},
+        {"num_iterations", required_argument, NULL, 'n'},
+        {"num_speakers",   required_argument, NULL, 'k'},
+        {"membw_threads",  required_argument, NULL, 'b'},
+        {"cache_threads",  required_argument, NULL, 'c'},
+        {"cpu_threads",    required_argument, NULL, 'p'},
+        {NULL,             0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY -t INPUT_PROFILE_PATH [-n NUM_ITERATIONS -k NUM_SPEAKERS,... "
+            "-b MEMBW_THREADS -c CACHE_THREADS -p CPU_THREADS] WAV_AUDIO_PATH\n",
+            program_name);
+}
+
+typedef enum {
+    STRESSOR_MEMORY_BANDWIDTH = 0,
+    STRESSOR_CACHE,
+    STRESSOR_CPU,
+} stressor_t;
+
+static const char *STRESSOR_NAMES[] = {"membw", "cache", "cpu"};
+
+static size_t llc_size_bytes() {
+    long size = -1;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    return (size > 0) ? static_cast<size_t>(size) : (32u * 1024u * 1024u);
+}
+
+// Streams through a buffer much larger than the LLC, reading and writing every cache line.
+static void stress_memory_bandwidth(const std::atomic<bool> &stop) {
+    const size_t num_bytes = std::max<size_t>(4 * llc_size_bytes(), 64u * 1024u * 1024u);
+    std::vector<uint8_t> source(num_bytes, 1);
+    std::vector<uint8_t> destination(num_bytes, 0);
+    while (!stop) {
+        std::memcpy(destination.data(), source.data(), num_bytes);
+        std::swap(source, destination);
+    }
+}
+
+// Chases a random cyclic permutation over twice the LLC size, evicting whatever the engine keeps in the cache.
+static void stress_cache(const std::atomic<bool> &stop, uint32_t seed) {
+    const size_t line_bytes = 64;
+    const size_t num_lines = (2 * llc_size_bytes()) / line_bytes;
+    const size_t stride = line_bytes / sizeof(size_t);
+
+    std::vector<size_t> order(num_lines);
+    for (size_t i = 0; i < num_lines; i++) {
+        order[i] = i;
+    }
+    for (size_t i = num_lines - 1; i > 0; i--) {
+        seed = (seed * 1664525u) + 1013904223u;
+        std::swap(order[i], order[seed % (i + 1)]);
+    }
+
+    std::vector<size_t> next(num_lines * stride);
+    for (size_t i = 0; i < num_lines; i++) {
+        next[order[i] * stride] = order[(i + 1) % num_lines] * stride;
+    }
+
+    volatile size_t index = 0;
+    while (!stop) {
+        for (size_t i = 0; i < 4096; i++) {
+            index = next[index];
+        }
+    }
+}
+
+static void stress_cpu(const std::atomic<bool> &stop) {
+    volatile double x = 1.0;
+    while (!stop) {
+        for (int32_t i = 0; i < 100000; i++) {
+            x = (x * 1.000001) + 0.000001;
+        }
+    }
+}
+
+static std::vector<int16_t> read_wav(const char *wav_audio_path) {
+    drwav wav_audio_file;
+    if (!drwav_init_file(&wav_audio_file, wav_audio_path, NULL)) {
+        fprintf(stderr, "failed to open wav file at '%s'.\n", wav_audio_path);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((wav_audio_file.sampleRate != static_cast<uint32_t>(pv::eagle::sample_rate())) ||
+        (wav_audio_file.bitsPerSample != 16) ||
+        (wav_audio_file.channels != 1)) {
+        fprintf(stderr, "audio should be single-channel 16-bit PCM at %d Hz.\n", pv::eagle::sample_rate());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<int16_t> pcm(wav_audio_file.totalPCMFrameCount);
+    drwav_read_pcm_frames_s16(&wav_audio_file, pcm.size(), pcm.data());
+    drwav_uninit(&wav_audio_file);
+
+    return pcm;
+}
+
+static std::vector<uint8_t> read_profile(const char *input_profile_path) {
+    FILE *input_profile_file = fopen(input_profile_path, "rb");
+    if (!input_profile_file) {
+        fprintf(stderr, "failed to open speaker profile file at '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fseek(input_profile_file, 0, SEEK_END);
+    std::vector<uint8_t> profile(static_cast<size_t>(ftell(input_profile_file)));
+    rewind(input_profile_file);
+
+    const size_t num_bytes = fread(profile.data(), sizeof(uint8_t), profile.size(), input_profile_file);
+    fclose(input_profile_file);
+    if (num_bytes != profile.size()) {
+        fprintf(stderr, "failed to read speaker profile from '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    return profile;
+}
+
+struct latency_summary {
+    double p50_usec;
+    double p99_usec;
+    double p999_usec;
+    uint64_t counter_values[PERF_COUNTER_NUM];
+    bool is_counter_available[PERF_COUNTER_NUM];
+    size_t num_frames;
+};
+
+static latency_summary measure(
+        pv::eagle::Eagle &eagle,
+        const std::vector<int16_t> &pcm,
+        int32_t num_iterations) {
+    const size_t frame_length = static_cast<size_t>(pv::eagle::Eagle::frame_length());
+    const size_t num_frames = pcm.size() / frame_length;
+    std::vector<float> scores(eagle.num_speakers());
+    std::vector<double> latencies_usec;
+    latencies_usec.reserve(num_frames * num_iterations);
+
+    latency_summary summary;
+    perf_counters_t counters;
+    perf_counters_open(&counters);
+
+    for (int32_t i = 0; i < num_iterations; i++) {
+        for (size_t j = 0; j < num_frames; j++) {
+            perf_counters_start(&counters);
+            const auto before = std::chrono::steady_clock::now();
+            const pv::eagle::Expected<void> status = eagle.process(
+                    pv::eagle::Span<const int16_t>(&pcm[j * frame_length], frame_length),
+                    scores);
+            const auto after = std::chrono::steady_clock::now();
+            perf_counters_stop(&counters);
+            if (!status) {
+                fprintf(stderr, "failed to process audio with '%s'\n", status.error().message());
+                exit(EXIT_FAILURE);
+            }
+            latencies_usec.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+        }
+        eagle.reset();
+    }
+
+    // the counts are copied out before closing, since closing marks every counter as unavailable
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        summary.counter_values[i] = counters.values[i];
+        summary.is_counter_available[i] = perf_counters_is_available(&counters, static_cast<perf_counter_t>(i));
+    }
+    perf_counters_close(&counters);
+
+    std::sort(latencies_usec.begin(), latencies_usec.end());
+    const size_t n = latencies_usec.size();
+    summary.p50_usec = latencies_usec[n / 2];
+    summary.p99_usec = latencies_usec[std::min(n - 1, (n * 99) / 100)];
+    summary.p999_usec = latencies_usec[std::min(n - 1, (n * 999) / 1000)];
+    summary.num_frames = n;
+    return summary;
+}
+
+static void print_per_frame(const latency_summary &summary, perf_counter_t counter) {
+    if (summary.is_counter_available[counter]) {
+        fprintf(stdout, " %12.0f", static_cast<double>(summary.counter_values[counter]) / summary.num_frames);
+    } else {
+        fprintf(stdout, " %12s", "n/a");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *input_profile_path = NULL;
+    int32_t num_iterations = 10;
+    std::vector<int32_t> num_speakers_list = {1};
+    int32_t num_stressor_threads[] = {-1, -1, -1};
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:t:n:k:b:c:p:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 't':
+                input_profile_path = optarg;
+                break;
+            case 'n':
+                num_iterations = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'k': {
+                num_speakers_list.clear();
+                char *token = strtok(optarg, ",");
+                while (token) {
+                    num_speakers_list.push_back(static_cast<int32_t>(strtol(token, NULL, 10)));
+                    token = strtok(NULL, ",");
+                }
+                break;
+            }
+            case 'b':
+                num_stressor_threads[STRESSOR_MEMORY_BANDWIDTH] = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'c':
+                num_stressor_threads[STRESSOR_CACHE] = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'p':
+                num_stressor_threads[STRESSOR_CPU] = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    const bool invalid_num_speakers = std::any_of(
+            num_speakers_list.begin(),
+            num_speakers_list.end(),
+            [](int32_t num_speakers) { return num_speakers < 1; });
+    if (!access_key || !model_path || !input_profile_path || (num_iterations < 1) || num_speakers_list.empty() ||
+        invalid_num_speakers || ((argc - optind) != 1)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const std::vector<int16_t> pcm = read_wav(argv[optind]);
+    if (pcm.size() < static_cast<size_t>(pv::eagle::Eagle::frame_length())) {
+        fprintf(stderr, "audio is shorter than a frame.\n");
+        exit(EXIT_FAILURE);
+    }
+    const std::vector<uint8_t> profile_bytes = read_profile(input_profile_path);
+
+    // by default every stressor type fills the CPUs the quota leaves besides the measured thread
+    const pv::eagle::ResourceLimits limits = pv::eagle::resource_limits();
+    const int32_t default_stressor_threads = std::max(
+            static_cast<int32_t>(pv::eagle::num_worker_threads(limits)) - 1,
+            1);
+    for (int32_t &num_threads : num_stressor_threads) {
+        if (num_threads < 0) {
+            num_threads = default_stressor_threads;
+        }
+    }
+
+    // scenario 0 is the baseline; the last one runs every stressor type at once
+    std::vector<std::vector<stressor_t>> scenarios = {{}};
+    std::vector<std::string> scenario_names = {"none"};
+    std::vector<stressor_t> all_stressors;
+    for (int32_t s = STRESSOR_MEMORY_BANDWIDTH; s <= STRESSOR_CPU; s++) {
+        if (num_stressor_threads[s] > 0) {
+            scenarios.push_back({static_cast<stressor_t>(s)});
+            scenario_names.push_back(std::string(STRESSOR_NAMES[s]) + "x" + std::to_string(num_stressor_threads[s]));
+            all_stressors.push_back(static_cast<stressor_t>(s));
+        }
+    }
+    if (all_stressors.size() > 1) {
+        scenarios.push_back(all_stressors);
+        scenario_names.push_back("all");
+    }
+
+    fprintf(stdout,
+            "v%s, LLC %zu KiB, cpu limit %.2f%s\n\n",
+            pv::eagle::version(),
+            llc_size_bytes() / 1024,
+            limits.cpus,
+            limits.is_cgroup_limited ? " (cgroup)" : "");
+    fprintf(stdout,
+            "%8s %-12s %10s %10s %10s %10s %12s %12s %6s\n",
+            "speakers",
+            "stressors",
+            "p50 (us)",
+            "p99 (us)",
+            "p99.9 (us)",
+            "p99 ratio",
+            "llc/frame",
+            "dtlb/frame",
+            "ipc");
+
+    for (int32_t num_speakers : num_speakers_list) {
+        std::vector<pv::eagle::Profile> profiles;
+        for (int32_t i = 0; i < num_speakers; i++) {
+            profiles.push_back(pv::eagle::Profile::from_bytes(profile_bytes));
+        }
+
+        pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(access_key, model_path, profiles);
+        if (!eagle) {
+            fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+            exit(EXIT_FAILURE);
+        }
+
+        // warm-up
+        (void) measure(*eagle, pcm, 1);
+
+        double baseline_p99_usec = 0.0;
+        for (size_t i = 0; i < scenarios.size(); i++) {
+            std::atomic<bool> stop = false;
+            std::vector<std::thread> stressors;
+            for (stressor_t stressor : scenarios[i]) {
+                for (int32_t j = 0; j < num_stressor_threads[stressor]; j++) {
+                    switch (stressor) {
+                        case STRESSOR_MEMORY_BANDWIDTH:
+                            stressors.emplace_back(stress_memory_bandwidth, std::cref(stop));
+                            break;
+                        case STRESSOR_CACHE:
+                            stressors.emplace_back(stress_cache, std::cref(stop), static_cast<uint32_t>(j + 1));
+                            break;
+                        case STRESSOR_CPU:
+                            stressors.emplace_back(stress_cpu, std::cref(stop));
+                            break;
+                    }
+                }
+            }
+
+            // let the stressors allocate and fill their working sets before measuring
+            std::this_thread::sleep_for(std::chrono::milliseconds(scenarios[i].empty() ? 0 : 500));
+
+            const latency_summary summary = measure(*eagle, pcm, num_iterations);
+
+            stop = true;
+            for (std::thread &stressor : stressors) {
+                stressor.join();
+            }
+
+            if (i == 0) {
+                baseline_p99_usec = summary.p99_usec;
+            }
+            fprintf(stdout,
+                    "%8d %-12s %10.0f %10.0f %10.0f %9.2fx",
+                    num_speakers,
+                    scenario_names[i].c_str(),
+                    summary.p50_usec,
+                    summary.p99_usec,
+                    summary.p999_usec,
+                    summary.p99_usec / baseline_p99_usec);
+            print_per_frame(summary, PERF_COUNTER_LLC_MISSES);
+            print_per_frame(summary, PERF_COUNTER_DTLB_MISSES);
+            const uint64_t cycles = summary.counter_values[PERF_COUNTER_CYCLES];
+            if (summary.is_counter_available[PERF_COUNTER_CYCLES] &&
+                summary.is_counter_available[PERF_COUNTER_INSTRUCTIONS] && (cycles > 0)) {
+                fprintf(stdout,
+                        " %6.2f\n",
+                        static_cast<double>(summary.counter_values[PERF_COUNTER_INSTRUCTIONS]) / cycles);
+            } else {
+                fprintf(stdout, " %6s\n", "n/a");
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
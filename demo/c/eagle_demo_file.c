@@ -10,12 +10,16 @@
 */
 
 #include <getopt.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 
+#include <fcntl.h>
+#include <io.h>
 #include <windows.h>
 
 #define UTF8_COMPOSITION_FLAG (0)
@@ -33,6 +37,8 @@
 
 #include "pv_eagle.h"
 
+#define RAW_PCM_BUFFER_SIZE_BYTES (1 << 20)
+
 static void *open_dl(const char *dl_path) {
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -91,11 +97,14 @@ static struct option long_options[] = {
         {"model_path",          required_argument, NULL, 'm'},
         {"enroll",              required_argument, NULL, 'e'},
         {"test",                required_argument, NULL, 't'},
+        {"raw_pcm",             no_argument,       NULL, 'r'},
+        {NULL,                  0,                 NULL, 0},
 };
 
 void print_usage(const char *program_name) {
     fprintf(stdout,
-            "Usage: %s [-e OUTPUT_PROFILE_PATH | -t INPUT_PROFILE_PATH] [-l LIBRARY_PATH -m MODEL_PATH -a ACCESS_KEY WAV_AUDIO_PATH_1 WAV_AUDIO_PATH_2 ...]\n",
+            "Usage: %s [-e OUTPUT_PROFILE_PATH | -t INPUT_PROFILE_PATH [-r]] [-l LIBRARY_PATH -m MODEL_PATH -a ACCESS_KEY WAV_AUDIO_PATH_1 WAV_AUDIO_PATH_2 ...]\n"
+            "With -r, test audio is raw 16-bit little-endian single-channel PCM at Eagle's sample rate, and '-' reads it from stdin.\n",
             program_name);
 }
 
@@ -341,6 +350,7 @@ void speaker_recognition(
         const char *model_path,
         void *eagle_library,
         const char *input_profile_path,
+        bool is_raw_pcm,
         int32_t num_audio_paths,
         const char *audio_paths[]) {
 
@@ -448,46 +458,91 @@ void speaker_recognition(
     double total_processed_time_usec = 0;
 
     for (int32_t i = 0; i < num_audio_paths; i++) {
-        const char *wav_audio_path = audio_paths[i];
+        const char *audio_path = audio_paths[i];
 
         drwav wav_audio_file;
+        FILE *raw_pcm_file = NULL;
+
+        if (is_raw_pcm) {
+            if (strcmp(audio_path, "-") == 0) {
+                raw_pcm_file = stdin;
 
 #if defined(_WIN32) || defined(_WIN64)
 
-        int wav_audio_path_wchars_num = MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, wav_audio_path, NULL_TERMINATED, NULL, 0);
-            wchar_t wav_audio_path_wchars[wav_audio_path_wchars_num];
-            MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, wav_audio_path, NULL_TERMINATED, wav_audio_path_wchars, wav_audio_path_wchars_num);
-            int drwav_init_file_status = drwav_init_file_w(&wav_audio_file, wav_audio_path_wchars, NULL);
+                _setmode(_fileno(stdin), _O_BINARY);
+
+#endif
+
+            } else {
+
+#if defined(_WIN32) || defined(_WIN64)
+
+                int audio_path_wchars_num = MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, audio_path, NULL_TERMINATED, NULL, 0);
+                wchar_t audio_path_wchars[audio_path_wchars_num];
+                MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, audio_path, NULL_TERMINATED, audio_path_wchars, audio_path_wchars_num);
+                raw_pcm_file = _wfopen(audio_path_wchars, L"rb");
 
 #else
 
-        int drwav_init_file_status = drwav_init_file(&wav_audio_file, wav_audio_path, NULL);
+                raw_pcm_file = fopen(audio_path, "rb");
 
 #endif
 
-        if (!drwav_init_file_status) {
-            fprintf(stderr, "failed to open wav file at '%s'.", wav_audio_path);
-            exit(EXIT_FAILURE);
-        }
+            }
 
-        if (wav_audio_file.sampleRate != (uint32_t) pv_sample_rate_func()) {
-            fprintf(stderr, "audio sample rate should be %d\n.", pv_sample_rate_func());
-            exit(EXIT_FAILURE);
-        }
+            if (!raw_pcm_file) {
+                fprintf(stderr, "failed to open raw PCM audio at '%s'.\n", audio_path);
+                exit(EXIT_FAILURE);
+            }
 
-        if (wav_audio_file.bitsPerSample != 16) {
-            fprintf(stderr, "audio format should be 16-bit\n.");
-            exit(EXIT_FAILURE);
-        }
+            // with a large stdio buffer, reading a frame at a time turns into a few large reads from the pipe, while
+            // `fread` still returns as soon as a whole frame has arrived
+            if (setvbuf(raw_pcm_file, NULL, _IOFBF, RAW_PCM_BUFFER_SIZE_BYTES) != 0) {
+                fprintf(stderr, "failed to set the read buffer of '%s'.\n", audio_path);
+                exit(EXIT_FAILURE);
+            }
+        } else {
 
-        if (wav_audio_file.channels != 1) {
-            fprintf(stderr, "audio should be single-channel.\n");
-            exit(EXIT_FAILURE);
+#if defined(_WIN32) || defined(_WIN64)
+
+            int wav_audio_path_wchars_num = MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, audio_path, NULL_TERMINATED, NULL, 0);
+                wchar_t wav_audio_path_wchars[wav_audio_path_wchars_num];
+                MultiByteToWideChar(CP_UTF8, UTF8_COMPOSITION_FLAG, audio_path, NULL_TERMINATED, wav_audio_path_wchars, wav_audio_path_wchars_num);
+                int drwav_init_file_status = drwav_init_file_w(&wav_audio_file, wav_audio_path_wchars, NULL);
+
+#else
+
+            int drwav_init_file_status = drwav_init_file(&wav_audio_file, audio_path, NULL);
+
+#endif
+
+            if (!drwav_init_file_status) {
+                fprintf(stderr, "failed to open wav file at '%s'.", audio_path);
+                exit(EXIT_FAILURE);
+            }
+
+            if (wav_audio_file.sampleRate != (uint32_t) pv_sample_rate_func()) {
+                fprintf(stderr, "audio sample rate should be %d\n.", pv_sample_rate_func());
+                exit(EXIT_FAILURE);
+            }
+
+            if (wav_audio_file.bitsPerSample != 16) {
+                fprintf(stderr, "audio format should be 16-bit\n.");
+                exit(EXIT_FAILURE);
+            }
+
+            if (wav_audio_file.channels != 1) {
+                fprintf(stderr, "audio should be single-channel.\n");
+                exit(EXIT_FAILURE);
+            }
         }
 
-        fprintf(stdout, "audio file: %s\n", wav_audio_path);
-        while ((int32_t) drwav_read_pcm_frames_s16(&wav_audio_file, pv_eagle_frame_length_func(), pcm) ==
-               pv_eagle_frame_length_func()) {
+        const int32_t frame_length = pv_eagle_frame_length_func();
+
+        fprintf(stdout, "audio file: %s\n", audio_path);
+        while (is_raw_pcm ?
+               (fread(pcm, sizeof(int16_t), frame_length, raw_pcm_file) == (size_t) frame_length) :
+               ((int32_t) drwav_read_pcm_frames_s16(&wav_audio_file, frame_length, pcm) == frame_length)) {
             struct timeval before;
             gettimeofday(&before, NULL);
 
@@ -503,13 +558,28 @@ void speaker_recognition(
             struct timeval after;
             gettimeofday(&after, NULL);
 
+            // scores of streamed audio are passed on as they are computed rather than when the stdout buffer fills up
+            if (is_raw_pcm) {
+                fflush(stdout);
+            }
+
             total_cpu_time_usec += (double) (after.tv_sec - before.tv_sec) * 1e6 +
                                    (double) (after.tv_usec - before.tv_usec);
             total_processed_time_usec +=
-                    (pv_eagle_frame_length_func() * 1e6) / pv_sample_rate_func();
+                    (frame_length * 1e6) / pv_sample_rate_func();
         }
 
-        drwav_uninit(&wav_audio_file);
+        if (is_raw_pcm) {
+            if (ferror(raw_pcm_file)) {
+                fprintf(stderr, "failed to read raw PCM audio from '%s'.\n", audio_path);
+                exit(EXIT_FAILURE);
+            }
+            if (raw_pcm_file != stdin) {
+                fclose(raw_pcm_file);
+            }
+        } else {
+            drwav_uninit(&wav_audio_file);
+        }
     }
 
     const double real_time_factor =
@@ -528,9 +598,10 @@ int picovoice_main(int argc, char *argv[]) {
     const char *model_path = NULL;
     const char *input_profile_path = NULL;
     const char *output_profile_path = NULL;
+    bool is_raw_pcm = false;
 
     int c;
-    while ((c = getopt_long(argc, argv, "a:l:m:e:t:", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "a:l:m:e:t:r", long_options, NULL)) != -1) {
         switch (c) {
             case 'l':
                 library_path = optarg;
@@ -547,6 +618,9 @@ int picovoice_main(int argc, char *argv[]) {
             case 't':
                 input_profile_path = optarg;
                 break;
+            case 'r':
+                is_raw_pcm = true;
+                break;
             default:
                 exit(EXIT_FAILURE);
         }
@@ -569,6 +643,12 @@ int picovoice_main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
 
+    if (is_raw_pcm && output_profile_path) {
+        fprintf(stderr, "Raw PCM input is only supported in test mode\n");
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
     int32_t num_audio_paths = argc - optind;
     if (num_audio_paths < 1) {
         fprintf(stderr, "Please provide at least one audio file.\n");
@@ -616,6 +696,7 @@ int picovoice_main(int argc, char *argv[]) {
                 model_path,
                 eagle_library,
                 input_profile_path,
+                is_raw_pcm,
                 num_audio_paths,
                 (const char **) &argv[optind]);
     }
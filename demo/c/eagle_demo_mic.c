@@ -13,6 +13,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/time.h>
 
 #if defined(_WIN32) || defined(_WIN64)
 
@@ -27,6 +28,7 @@
 
 #endif
 
+#include "eagle_capture.h"
 #include "pv_eagle.h"
 #include "pv_recorder.h"
 
@@ -91,13 +93,14 @@ static struct option long_options[] = {
         {"model_path",          required_argument, NULL, 'm'},
         {"enroll",              required_argument, NULL, 'e'},
         {"test",                required_argument, NULL, 't'},
+        {"capture_path",        required_argument, NULL, 'c'},
         {"show_audio_devices",  no_argument,       NULL, 's'},
-
+        {NULL,                  0,                 NULL, 0},
 };
 
 void print_usage(const char *program_name) {
     fprintf(stdout,
-            "Usage: %s [-s] [-e OUTPUT_PROFILE_PATH | -t INPUT_PROFILE_PATH] [-l LIBRARY_PATH -m MODEL_PATH -a ACCESS_KEY -d AUDIO_DEVICE_INDEX]\n",
+            "Usage: %s [-s] [-e OUTPUT_PROFILE_PATH | -t INPUT_PROFILE_PATH [-c CAPTURE_PATH]] [-l LIBRARY_PATH -m MODEL_PATH -a ACCESS_KEY -d AUDIO_DEVICE_INDEX]\n",
             program_name);
 }
 
@@ -349,6 +352,7 @@ void speaker_recognition(
         const char *access_key,
         const char *model_path,
         const char *input_profile_path,
+        const char *capture_path,
         void *eagle_library,
         pv_recorder_t *recorder) {
 
@@ -462,6 +466,23 @@ void speaker_recognition(
         exit(EXIT_FAILURE);
     }
 
+    eagle_capture_t capture;
+    struct timeval capture_start;
+    gettimeofday(&capture_start, NULL);
+    if (capture_path) {
+        const int32_t speaker_profile_size_bytes = (int32_t) speaker_profile_size;
+        if (!eagle_capture_open_write(&capture, capture_path, pv_sample_rate_func(), frame_length) ||
+            !eagle_capture_write_profiles(
+                    &capture,
+                    0,
+                    1,
+                    (const void *const *) &speaker_profile,
+                    &speaker_profile_size_bytes)) {
+            fprintf(stderr, "failed to open '%s' for capture\n", capture_path);
+            exit(EXIT_FAILURE);
+        }
+    }
+
     fprintf(stdout, "Listening... (press Ctrl+C to stop)\n");
     while (!is_interrupted) {
         recorder_status = pv_recorder_read(recorder, pcm);
@@ -470,12 +491,35 @@ void speaker_recognition(
             exit(EXIT_FAILURE);
         }
 
+        struct timeval arrival;
+        gettimeofday(&arrival, NULL);
+        const uint64_t timestamp_usec = (uint64_t) ((arrival.tv_sec - capture_start.tv_sec) * 1000000LL +
+                                                    (arrival.tv_usec - capture_start.tv_usec));
+        if (capture_path && !eagle_capture_write_frame(&capture, timestamp_usec, pcm)) {
+            fprintf(stderr, "failed to write to capture '%s'\n", capture_path);
+            exit(EXIT_FAILURE);
+        }
+
+        // only the engine call is timed, so that writing the capture does not count as processing latency
+        struct timeval process_start;
+        gettimeofday(&process_start, NULL);
         eagle_status = pv_eagle_process_func(eagle, pcm, &score);
+        struct timeval process_end;
+        gettimeofday(&process_end, NULL);
         if (eagle_status != PV_STATUS_SUCCESS) {
             fprintf(stderr, "Failed to process audio with %s.\n", pv_status_to_string_func(eagle_status));
             exit(EXIT_FAILURE);
         }
 
+        if (capture_path) {
+            const uint32_t process_usec = (uint32_t) ((process_end.tv_sec - process_start.tv_sec) * 1000000LL +
+                                                      (process_end.tv_usec - process_start.tv_usec));
+            if (!eagle_capture_write_scores(&capture, timestamp_usec, process_usec, 1, &score)) {
+                fprintf(stderr, "failed to write to capture '%s'\n", capture_path);
+                exit(EXIT_FAILURE);
+            }
+        }
+
         fprintf(stdout, "\r[score: %.2f]", score);
         fflush(stdout);
     }
@@ -487,6 +531,10 @@ void speaker_recognition(
         exit(1);
     }
 
+    if (capture_path) {
+        eagle_capture_close(&capture);
+    }
+
     free(pcm);
     free(speaker_profile);
     pv_eagle_delete_func(eagle);
@@ -500,10 +548,11 @@ int picovoice_main(int argc, char *argv[]) {
     const char *model_path = NULL;
     const char *input_profile_path = NULL;
     const char *output_profile_path = NULL;
+    const char *capture_path = NULL;
     int32_t device_index = -1;
 
     int c;
-    while ((c = getopt_long(argc, argv, "sa:d:l:m:e:t:", long_options, NULL)) != -1) {
+    while ((c = getopt_long(argc, argv, "sa:d:l:m:e:t:c:", long_options, NULL)) != -1) {
         switch (c) {
             case 's':
                 show_audio_devices();
@@ -520,6 +569,9 @@ int picovoice_main(int argc, char *argv[]) {
             case 't':
                 input_profile_path = optarg;
                 break;
+            case 'c':
+                capture_path = optarg;
+                break;
             case 'm':
                 model_path = optarg;
                 break;
@@ -548,6 +600,12 @@ int picovoice_main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
 
+    if (output_profile_path && capture_path) {
+        fprintf(stderr, "Capture is only supported in test mode\n");
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
     void *eagle_library = open_dl(library_path);
     if (!eagle_library) {
         fprintf(stderr, "failed to open library at '%s'.\n", library_path);
@@ -590,6 +648,7 @@ int picovoice_main(int argc, char *argv[]) {
                 access_key,
                 model_path,
                 input_profile_path,
+                capture_path,
                 eagle_library,
                 recorder);
     }
@@ -0,0 +1,360 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <getopt.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DR_WAV_IMPLEMENTATION
+
+#include "dr_wav.h"
+
+#include "pv_eagle.hpp"
+#include "pv_eagle_resources.hpp"
+
+// Measures how NUMA placement affects Eagle throughput on multi-socket hosts. Every Eagle instance reads its own copy of
+// the model weights, allocated by the thread that calls `pv_eagle_init()`. For every pair of nodes, worker threads
+// create their instances while pinned to the load node, with memory allocation preferring that node, and then process
+// audio while pinned to the run node. Pairs where the two nodes match measure local placement (one replica per node,
+// workers on that node's cores); the others measure what workers pay for reading weights from a remote node.
+
+static struct option long_options[] = {
+        {"access_key",       required_argument, NULL, 'a'},
+        {"model_path",       required_argument, NULL, 'm'},
+        {"test",             required_argument, NULL, 't'},
+        {"threads_per_node", required_argument, NULL, 'j'},
+        {"duration_sec",     required_argument, NULL, 'd'},
+        {NULL,               0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY -t INPUT_PROFILE_PATH [-j THREADS_PER_NODE -d DURATION_SEC] "
+            "WAV_AUDIO_PATH\n",
+            program_name);
+}
+
+struct numa_node {
+    int32_t id;
+    std::vector<int32_t> cpus;
+};
+
+// Parses a sysfs CPU list such as `0-3,8-11`.
+static std::vector<int32_t> parse_cpu_list(const char *cpu_list) {
+    std::vector<int32_t> cpus;
+    const char *cursor = cpu_list;
+    while (*cursor && (*cursor != '\n')) {
+        char *end = NULL;
+        const long first = strtol(cursor, &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<int32_t>(cpu));
+        }
+        cursor = (*end == ',') ? (end + 1) : end;
+    }
+    return cpus;
+}
+
+static std::vector<numa_node> numa_nodes() {
+    std::vector<numa_node> nodes;
+    for (int32_t id = 0; id < 1024; id++) {
+        const std::string path = "/sys/devices/system/node/node" + std::to_string(id) + "/cpulist";
+        FILE *file = fopen(path.c_str(), "r");
+        if (!file) {
+            continue;
+        }
+
+        char cpu_list[4096] = {0};
+        const bool is_read = fgets(cpu_list, sizeof(cpu_list), file) != NULL;
+        fclose(file);
+        if (is_read) {
+            std::vector<int32_t> cpus = parse_cpu_list(cpu_list);
+            if (!cpus.empty()) {
+                nodes.push_back({id, std::move(cpus)});
+            }
+        }
+    }
+
+    // kernels built without NUMA support do not expose any nodes; treat the whole machine as a single node
+    if (nodes.empty()) {
+        numa_node node = {0, {}};
+        for (int32_t cpu = 0; cpu < static_cast<int32_t>(std::thread::hardware_concurrency()); cpu++) {
+            node.cpus.push_back(cpu);
+        }
+        nodes.push_back(std::move(node));
+    }
+
+    return nodes;
+}
+
+static void pin_to_node(const numa_node &node) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int32_t cpu : node.cpus) {
+        CPU_SET(cpu, &cpu_set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+}
+
+// Makes the calling thread allocate from `node` when possible, or restores the default policy when `node` is NULL.
+static void prefer_node_memory(const numa_node *node) {
+    if (!node) {
+        syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0);
+        return;
+    }
+
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = {0};
+    mask[node->id / (8 * sizeof(unsigned long))] |= 1ul << (node->id % (8 * sizeof(unsigned long)));
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, 1024);
+}
+
+static std::vector<int16_t> read_wav(const char *wav_audio_path) {
+    drwav wav_audio_file;
+    if (!drwav_init_file(&wav_audio_file, wav_audio_path, NULL)) {
+        fprintf(stderr, "failed to open wav file at '%s'.\n", wav_audio_path);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((wav_audio_file.sampleRate != static_cast<uint32_t>(pv::eagle::sample_rate())) ||
+        (wav_audio_file.bitsPerSample != 16) ||
+        (wav_audio_file.channels != 1)) {
+        fprintf(stderr, "audio should be single-channel 16-bit PCM at %d Hz.\n", pv::eagle::sample_rate());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<int16_t> pcm(wav_audio_file.totalPCMFrameCount);
+    drwav_read_pcm_frames_s16(&wav_audio_file, pcm.size(), pcm.data());
+    drwav_uninit(&wav_audio_file);
+
+    return pcm;
+}
+
+static std::vector<uint8_t> read_profile(const char *input_profile_path) {
+    FILE *input_profile_file = fopen(input_profile_path, "rb");
+    if (!input_profile_file) {
+        fprintf(stderr, "failed to open speaker profile file at '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fseek(input_profile_file, 0, SEEK_END);
+    std::vector<uint8_t> profile(static_cast<size_t>(ftell(input_profile_file)));
+    rewind(input_profile_file);
+
+    const size_t num_bytes = fread(profile.data(), sizeof(uint8_t), profile.size(), input_profile_file);
+    fclose(input_profile_file);
+    if (num_bytes != profile.size()) {
+        fprintf(stderr, "failed to read speaker profile from '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    return profile;
+}
+
+// Runs `num_threads` workers that load on `load_node` and process on `run_node`, and returns the aggregate number of
+// seconds of audio processed per second.
+static double measure(
+        const char *access_key,
+        const char *model_path,
+        const std::vector<uint8_t> &profile_bytes,
+        const std::vector<int16_t> &pcm,
+        const numa_node &load_node,
+        const numa_node &run_node,
+        int32_t num_threads,
+        double duration_sec) {
+    const size_t frame_length = static_cast<size_t>(pv::eagle::Eagle::frame_length());
+    const size_t num_frames = pcm.size() / frame_length;
+
+    std::atomic<int32_t> num_ready = 0;
+    std::atomic<bool> go = false;
+    std::atomic<bool> stop = false;
+    std::atomic<uint64_t> total_frames = 0;
+    std::vector<std::thread> threads;
+
+    for (int32_t i = 0; i < num_threads; i++) {
+        threads.emplace_back([&] {
+            // the replica, the profile and the audio are all allocated while bound to the load node
+            pin_to_node(load_node);
+            prefer_node_memory(&load_node);
+            const pv::eagle::Profile profile = pv::eagle::Profile::from_bytes(profile_bytes);
+            const std::vector<int16_t> local_pcm(pcm);
+            pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(
+                    access_key,
+                    model_path,
+                    pv::eagle::Span<const pv::eagle::Profile>(&profile, 1));
+            std::vector<float> scores(1);
+            prefer_node_memory(NULL);
+            pin_to_node(run_node);
+
+            if (!eagle) {
+                fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+                exit(EXIT_FAILURE);
+            }
+
+            num_ready++;
+            while (!go) {
+                std::this_thread::yield();
+            }
+
+            uint64_t frames = 0;
+            while (!stop) {
+                const pv::eagle::Expected<void> status = eagle->process(
+                        pv::eagle::Span<const int16_t>(&local_pcm[(frames % num_frames) * frame_length], frame_length),
+                        scores);
+                if (!status) {
+                    fprintf(stderr, "failed to process audio with '%s'\n", status.error().message());
+                    exit(EXIT_FAILURE);
+                }
+                frames++;
+            }
+            total_frames += frames;
+        });
+    }
+
+    while (num_ready < num_threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    std::this_thread::sleep_for(std::chrono::duration<double>(duration_sec));
+    stop = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const double elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double audio_sec = static_cast<double>(total_frames * frame_length) /
+                             static_cast<double>(pv::eagle::sample_rate());
+    return audio_sec / elapsed_sec;
+}
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *input_profile_path = NULL;
+    int32_t threads_per_node = 0;
+    double duration_sec = 10.0;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:t:j:d:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 't':
+                input_profile_path = optarg;
+                break;
+            case 'j':
+                threads_per_node = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'd':
+                duration_sec = strtod(optarg, NULL);
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!access_key || !model_path || !input_profile_path || (threads_per_node < 0) || (duration_sec <= 0.0) ||
+        (optind + 1 != argc)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const std::vector<int16_t> pcm = read_wav(argv[optind]);
+    if (pcm.size() < static_cast<size_t>(pv::eagle::Eagle::frame_length())) {
+        fprintf(stderr, "audio is shorter than a frame.\n");
+        exit(EXIT_FAILURE);
+    }
+    const std::vector<uint8_t> profile_bytes = read_profile(input_profile_path);
+
+    const std::vector<numa_node> nodes = numa_nodes();
+
+    // every case runs on a single node, so by default it gets as many threads as the CPU quota and the smallest node
+    // allow
+    const pv::eagle::ResourceLimits limits = pv::eagle::resource_limits();
+    if (threads_per_node == 0) {
+        size_t num_threads = pv::eagle::num_worker_threads(limits);
+        for (const numa_node &node : nodes) {
+            num_threads = std::min(num_threads, node.cpus.size());
+        }
+        threads_per_node = static_cast<int32_t>(std::max<size_t>(num_threads, 1));
+    }
+    fprintf(stdout, "cpu limit %.2f%s\n", limits.cpus, limits.is_cgroup_limited ? " (cgroup)" : "");
+    fprintf(stdout, "%zu NUMA node(s), %d thread(s) per node, %.1f s per case\n", nodes.size(), threads_per_node,
+            duration_sec);
+    if (nodes.size() < 2) {
+        fprintf(stdout, "only one node found, remote placement cannot be measured\n");
+    }
+
+    fprintf(stdout, "\n%9s %9s %9s %16s\n", "load node", "run node", "placement", "audio sec / sec");
+    double local_sum = 0.0;
+    double remote_sum = 0.0;
+    int32_t num_local = 0;
+    int32_t num_remote = 0;
+    for (const numa_node &load_node : nodes) {
+        for (const numa_node &run_node : nodes) {
+            const double throughput = measure(
+                    access_key,
+                    model_path,
+                    profile_bytes,
+                    pcm,
+                    load_node,
+                    run_node,
+                    threads_per_node,
+                    duration_sec);
+            const bool is_local = load_node.id == run_node.id;
+            fprintf(stdout,
+                    "%9d %9d %9s %16.1f\n",
+                    load_node.id,
+                    run_node.id,
+                    is_local ? "local" : "remote",
+                    throughput);
+            if (is_local) {
+                local_sum += throughput;
+                num_local++;
+            } else {
+                remote_sum += throughput;
+                num_remote++;
+            }
+        }
+    }
+
+    if (num_remote > 0) {
+        const double local_mean = local_sum / num_local;
+        const double remote_mean = remote_sum / num_remote;
+        fprintf(stdout,
+                "\nmean local %.1f, mean remote %.1f audio sec / sec, remote placement costs %.1f%%\n",
+                local_mean,
+                remote_mean,
+                100.0 * (1.0 - (remote_mean / local_mean)));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include "pv_eagle_pipeline.hpp"
+
+// Scores the same raw PCM file as `num_streams` independent streams, each with its own Eagle instance and pipeline,
+// multiplexed over a work-stealing pool of `num_threads` threads. Unless given explicitly, the number of threads is
+// derived from the CPU quota of the process's cgroup, and the number of streams is capped so that their instances fit
+// within its memory limit.
+
+static struct option long_options[] = {
+        {"access_key",  required_argument, NULL, 'a'},
+        {"model_path",  required_argument, NULL, 'm'},
+        {"test",        required_argument, NULL, 't'},
+        {"num_streams", required_argument, NULL, 's'},
+        {"num_threads", required_argument, NULL, 'j'},
+        {NULL,          0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY -t INPUT_PROFILE_PATH [-s NUM_STREAMS -j NUM_THREADS] RAW_PCM_PATH\n",
+            program_name);
+}
+
+static std::vector<uint8_t> read_profile(const char *input_profile_path) {
+    FILE *input_profile_file = fopen(input_profile_path, "rb");
+    if (!input_profile_file) {
+        fprintf(stderr, "failed to open speaker profile file at '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fseek(input_profile_file, 0, SEEK_END);
+    std::vector<uint8_t> profile(static_cast<size_t>(ftell(input_profile_file)));
+    rewind(input_profile_file);
+
+    const size_t num_bytes = fread(profile.data(), sizeof(uint8_t), profile.size(), input_profile_file);
+    fclose(input_profile_file);
+    if (num_bytes != profile.size()) {
+        fprintf(stderr, "failed to read speaker profile from '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    return profile;
+}
+
+static size_t rss_bytes() {
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+
+    long num_pages = 0;
+    long num_resident_pages = 0;
+    const int num_read = fscanf(statm, "%ld %ld", &num_pages, &num_resident_pages);
+    fclose(statm);
+    if (num_read != 2) {
+        return 0;
+    }
+
+    return static_cast<size_t>(num_resident_pages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *input_profile_path = NULL;
+    int32_t num_streams = 8;
+    int32_t num_threads = 0;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:t:s:j:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 't':
+                input_profile_path = optarg;
+                break;
+            case 's':
+                num_streams = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'j':
+                num_threads = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!access_key || !model_path || !input_profile_path || (num_streams < 1) || (num_threads < 0) ||
+        ((argc - optind) != 1)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    const char *raw_pcm_path = argv[optind];
+    const std::vector<uint8_t> profile_bytes = read_profile(input_profile_path);
+    const pv::eagle::Profile profiles[] = {pv::eagle::Profile::from_bytes(profile_bytes)};
+
+    const pv::eagle::ResourceLimits limits = pv::eagle::resource_limits();
+    fprintf(stdout,
+            "cpu limit         : %.2f%s\n",
+            limits.cpus,
+            limits.is_cgroup_limited ? " (cgroup)" : "");
+    if (limits.memory_bytes > 0) {
+        fprintf(stdout, "memory limit      : %.1f MiB\n", static_cast<double>(limits.memory_bytes) / (1024.0 * 1024.0));
+    }
+    if (num_threads == 0) {
+        num_threads = static_cast<int32_t>(pv::eagle::ThreadPool::default_num_threads());
+    }
+
+    std::vector<pv::eagle::Eagle> eagles;
+    std::vector<int> fds;
+    for (int32_t i = 0; i < num_streams; i++) {
+        const size_t rss_before = rss_bytes();
+        pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(access_key, model_path, profiles);
+        if (!eagle) {
+            fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+            exit(EXIT_FAILURE);
+        }
+        eagles.push_back(std::move(eagle).value());
+
+        // size the pool of instances from what the first one costs, keeping a quarter of the limit as headroom
+        if ((i == 0) && (limits.memory_bytes > 0)) {
+            const size_t rss_after = rss_bytes();
+            const size_t instance_bytes = rss_after - std::min(rss_before, rss_after);
+            const int32_t max_streams = static_cast<int32_t>(pv::eagle::max_num_instances(
+                    limits,
+                    rss_before,
+                    instance_bytes,
+                    static_cast<size_t>(num_streams)));
+            if (max_streams < num_streams) {
+                num_streams = max_streams;
+                fprintf(stdout,
+                        "streams capped to %d by the memory limit (%.1f MiB per instance)\n",
+                        num_streams,
+                        static_cast<double>(instance_bytes) / (1024.0 * 1024.0));
+            }
+        }
+
+        const int fd = open(raw_pcm_path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "failed to open raw PCM file at '%s'.\n", raw_pcm_path);
+            exit(EXIT_FAILURE);
+        }
+        // a FIFO is read without blocking once its writer is connected, so a stream that runs dry does not hold a
+        // pool thread
+        pv::eagle::set_nonblocking(fd);
+        fds.push_back(fd);
+    }
+
+    const size_t frame_length = static_cast<size_t>(pv::eagle::Eagle::frame_length());
+    std::vector<pv::eagle::Expected<void>> statuses(num_streams);
+    std::atomic<int64_t> num_frames = 0;
+    std::latch done(num_streams);
+
+    const auto before = std::chrono::steady_clock::now();
+    {
+        pv::eagle::ThreadPool pool(static_cast<size_t>(num_threads));
+        for (int32_t i = 0; i < num_streams; i++) {
+            pv::eagle::run_pipeline(
+                    pool,
+                    pv::eagle::score(
+                            eagles[i],
+                            pv::eagle::frames(pv::eagle::read_pcm(fds[i], 16 * frame_length), frame_length),
+                            statuses[i]),
+                    [&num_frames](pv::eagle::Span<const float>) { num_frames.fetch_add(1, std::memory_order_relaxed); },
+                    [&done] { done.count_down(); },
+                    32,
+                    fds[i]);
+        }
+        done.wait();
+    }
+    const auto after = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < num_streams; i++) {
+        close(fds[i]);
+        if (!statuses[i]) {
+            fprintf(stderr, "failed to process audio with '%s'\n", statuses[i].error().message());
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const double elapsed_sec = std::chrono::duration<double>(after - before).count();
+    const double audio_sec = static_cast<double>(num_frames.load() * frame_length) / pv::eagle::sample_rate();
+    fprintf(stdout, "streams           : %d\n", num_streams);
+    fprintf(stdout, "threads           : %d\n", num_threads);
+    fprintf(stdout, "frames            : %lld\n", static_cast<long long>(num_frames.load()));
+    fprintf(stdout, "audio processed   : %.2f s\n", audio_sec);
+    fprintf(stdout, "wall time         : %.2f s\n", elapsed_sec);
+    fprintf(stdout, "throughput        : %.1fx real time\n", audio_sec / elapsed_sec);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <getopt.h>
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "eagle_capture.h"
+#include "pv_eagle.hpp"
+
+// Replays a session captured with `eagle_demo_mic -c CAPTURE_PATH` through Eagle. Frames are fed at their original
+// arrival times scaled by the replay speed (or back to back when the speed is 0), resets and profile changes are
+// applied where they happened, and the latency and scores of every frame are written as CSV so that runs against
+// different builds or models can be compared frame by frame. Captures that hold the scores and processing time of the
+// live session are checked against them; frames whose scores differ are reported and make the replay exit with a
+// failure status, as does a corrupt or partly written capture.
+//
+// With a shadow model, a second Eagle instance built from another model file receives the same frames and events on a
+// separate thread running at idle priority, so it only uses CPU time the primary instance leaves over and never delays
+// it. Its scores are written to their own CSV, keyed by the same frame index, and compared against the primary scores.
+
+static struct option long_options[] = {
+        {"access_key",         required_argument, NULL, 'a'},
+        {"model_path",         required_argument, NULL, 'm'},
+        {"replay_speed",       required_argument, NULL, 'r'},
+        {"output_path",        required_argument, NULL, 'o'},
+        {"shadow_model_path",  required_argument, NULL, 's'},
+        {"shadow_output_path", required_argument, NULL, 'O'},
+        {"score_tolerance",    required_argument, NULL, 'e'},
+        {NULL,                 0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY [-r REPLAY_SPEED -o OUTPUT_PATH -e SCORE_TOLERANCE] "
+            "[-s SHADOW_MODEL_PATH -O SHADOW_OUTPUT_PATH] CAPTURE_PATH\n",
+            program_name);
+}
+
+static const uint64_t MAX_REPORTED_MISMATCHES = 10;
+
+static double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+    return values[index];
+}
+
+struct shadow_task {
+    eagle_capture_record_type_t type;
+    uint64_t frame_index;
+    std::vector<int16_t> pcm;
+    std::vector<float> primary_scores;
+    std::vector<pv::eagle::Profile> profiles;
+};
+
+// Second Eagle instance that mirrors the primary one on a low-priority thread. Frames are queued without bound since
+// skipping any of them would change the shadow's internal state and make its scores incomparable.
+class shadow_model {
+public:
+    shadow_model(const char *access_key, const char *model_path, FILE *output_file)
+        : access_key_(access_key),
+          model_path_(model_path),
+          output_file_(output_file),
+          eagle_(pv::eagle::Error(PV_STATUS_INVALID_STATE)) {
+        fprintf(output_file_, "frame,process_usec,scores\n");
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void push(shadow_task task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+            max_backlog_ = std::max(max_backlog_, tasks_.size());
+        }
+        cv_.notify_one();
+    }
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_finished_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    void print_summary() const {
+        fprintf(stderr,
+                "shadow processed %llu frames, process p50 %.1f us p99 %.1f us, max backlog %zu frames, "
+                "score difference mean %.4f max %.4f\n",
+                static_cast<unsigned long long>(process_usec_.size()),
+                percentile(process_usec_, 0.5),
+                percentile(process_usec_, 0.99),
+                max_backlog_,
+                (num_scores_ > 0) ? (sum_abs_difference_ / static_cast<double>(num_scores_)) : 0.0,
+                max_abs_difference_);
+    }
+
+private:
+    void run() {
+#if defined(__linux__) && defined(SCHED_IDLE)
+        struct sched_param param = {};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+        std::vector<float> scores;
+        for (;;) {
+            shadow_task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return is_finished_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            switch (task.type) {
+                case EAGLE_CAPTURE_RECORD_PROFILES:
+                    eagle_ = pv::eagle::Eagle::create(access_key_, model_path_, task.profiles);
+                    if (!eagle_) {
+                        fprintf(stderr,
+                                "failed to create the shadow instance of eagle with '%s'\n",
+                                eagle_.error().message());
+                        exit(EXIT_FAILURE);
+                    }
+                    scores.assign(static_cast<size_t>(eagle_->num_speakers()), 0.0f);
+                    break;
+                case EAGLE_CAPTURE_RECORD_RESET:
+                    if (eagle_) {
+                        eagle_->reset();
+                    }
+                    break;
+                case EAGLE_CAPTURE_RECORD_SCORES:
+                    break;
+                case EAGLE_CAPTURE_RECORD_FRAME: {
+                    const auto before = std::chrono::steady_clock::now();
+                    const pv::eagle::Expected<void> status = eagle_->process(task.pcm, scores);
+                    const auto after = std::chrono::steady_clock::now();
+                    if (!status) {
+                        fprintf(stderr, "failed to process audio in the shadow with '%s'\n", status.error().message());
+                        exit(EXIT_FAILURE);
+                    }
+
+                    process_usec_.push_back(std::chrono::duration<double, std::micro>(after - before).count());
+                    fprintf(output_file_,
+                            "%llu,%.1f",
+                            static_cast<unsigned long long>(task.frame_index),
+                            process_usec_.back());
+                    for (size_t i = 0; i < scores.size(); i++) {
+                        fprintf(output_file_, ",%.4f", scores[i]);
+                        const double difference = std::fabs(scores[i] - task.primary_scores[i]);
+                        sum_abs_difference_ += difference;
+                        max_abs_difference_ = std::max(max_abs_difference_, difference);
+                        num_scores_++;
+                    }
+                    fprintf(output_file_, "\n");
+                    break;
+                }
+            }
+        }
+    }
+
+    const char *access_key_;
+    const char *model_path_;
+    FILE *output_file_;
+    pv::eagle::Expected<pv::eagle::Eagle> eagle_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<shadow_task> tasks_;
+    bool is_finished_ = false;
+    size_t max_backlog_ = 0;
+
+    std::vector<double> process_usec_;
+    double sum_abs_difference_ = 0.0;
+    double max_abs_difference_ = 0.0;
+    uint64_t num_scores_ = 0;
+
+    std::thread thread_;
+};
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *output_path = NULL;
+    const char *shadow_model_path = NULL;
+    const char *shadow_output_path = NULL;
+    double replay_speed = 1.0;
+    double score_tolerance = 1e-4;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:r:o:s:O:e:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 'r':
+                replay_speed = strtod(optarg, NULL);
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 's':
+                shadow_model_path = optarg;
+                break;
+            case 'O':
+                shadow_output_path = optarg;
+                break;
+            case 'e':
+                score_tolerance = strtod(optarg, NULL);
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!access_key || !model_path || (replay_speed < 0.0) || (score_tolerance < 0.0) || (optind + 1 != argc) ||
+        (!shadow_model_path != !shadow_output_path)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    const char *capture_path = argv[optind];
+
+    eagle_capture_t capture;
+    if (!eagle_capture_open_read(&capture, capture_path)) {
+        fprintf(stderr, "failed to read capture from '%s'.\n", capture_path);
+        exit(EXIT_FAILURE);
+    }
+    if ((capture.sample_rate != pv::eagle::sample_rate()) ||
+        (capture.frame_length != pv::eagle::Eagle::frame_length())) {
+        fprintf(stderr,
+                "capture was recorded at %d Hz with %d-sample frames, Eagle expects %d Hz with %d-sample frames.\n",
+                capture.sample_rate,
+                capture.frame_length,
+                pv::eagle::sample_rate(),
+                pv::eagle::Eagle::frame_length());
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *output_file = output_path ? fopen(output_path, "w") : stdout;
+    if (!output_file) {
+        fprintf(stderr, "failed to open '%s' for writing.\n", output_path);
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *shadow_output_file = NULL;
+    std::unique_ptr<shadow_model> shadow;
+    if (shadow_model_path) {
+        shadow_output_file = fopen(shadow_output_path, "w");
+        if (!shadow_output_file) {
+            fprintf(stderr, "failed to open '%s' for writing.\n", shadow_output_path);
+            exit(EXIT_FAILURE);
+        }
+        shadow = std::make_unique<shadow_model>(access_key, shadow_model_path, shadow_output_file);
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto usec_between = [](clock::time_point from, clock::time_point to) {
+        return std::chrono::duration<double, std::micro>(to - from).count();
+    };
+
+    pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Error(PV_STATUS_INVALID_STATE);
+    std::vector<float> scores;
+    std::vector<double> latencies_usec;
+    std::vector<double> process_usec;
+    std::vector<double> live_process_usec;
+    uint64_t frame_index = 0;
+    uint64_t num_mismatches = 0;
+    double max_live_difference = 0.0;
+
+    fprintf(output_file, "frame,arrival_usec,latency_usec,process_usec,scores\n");
+
+    const auto start = clock::now();
+    eagle_capture_record_t record;
+    eagle_capture_read_status_t read_status = EAGLE_CAPTURE_READ_RECORD;
+    while ((read_status = eagle_capture_read_record(&capture, &record)) == EAGLE_CAPTURE_READ_RECORD) {
+        // when replaying in real time (or a multiple of it) a frame is due at its scaled arrival time and its latency
+        // includes any time spent waiting behind earlier frames
+        auto due = clock::now();
+        if (replay_speed > 0.0) {
+            due = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::micro>(
+                                  static_cast<double>(record.timestamp_usec) / replay_speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        switch (record.type) {
+            case EAGLE_CAPTURE_RECORD_PROFILES: {
+                std::vector<pv::eagle::Profile> profiles;
+                for (int32_t i = 0; i < record.num_profiles; i++) {
+                    profiles.push_back(pv::eagle::Profile::from_bytes(pv::eagle::Span<const uint8_t>(
+                            static_cast<const uint8_t *>(record.profiles[i]),
+                            static_cast<size_t>(record.profile_sizes[i]))));
+                }
+                eagle = pv::eagle::Eagle::create(access_key, model_path, profiles);
+                if (!eagle) {
+                    fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+                    exit(EXIT_FAILURE);
+                }
+                scores.assign(static_cast<size_t>(eagle->num_speakers()), 0.0f);
+                if (shadow) {
+                    shadow_task task = {EAGLE_CAPTURE_RECORD_PROFILES, frame_index, {}, {}, {}};
+                    for (const pv::eagle::Profile &profile : profiles) {
+                        task.profiles.push_back(pv::eagle::Profile::from_bytes(profile.bytes()));
+                    }
+                    shadow->push(std::move(task));
+                }
+                break;
+            }
+            case EAGLE_CAPTURE_RECORD_RESET:
+                if (eagle) {
+                    eagle->reset();
+                }
+                if (shadow) {
+                    shadow->push({EAGLE_CAPTURE_RECORD_RESET, frame_index, {}, {}, {}});
+                }
+                break;
+            case EAGLE_CAPTURE_RECORD_FRAME: {
+                if (!eagle) {
+                    fprintf(stderr, "capture has audio before any speaker profiles.\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                const auto before = clock::now();
+                const pv::eagle::Expected<void> status = eagle->process(
+                        pv::eagle::Span<const int16_t>(record.pcm, static_cast<size_t>(capture.frame_length)),
+                        scores);
+                const auto after = clock::now();
+                if (!status) {
+                    fprintf(stderr, "failed to process audio with '%s'\n", status.error().message());
+                    exit(EXIT_FAILURE);
+                }
+
+                if (shadow) {
+                    shadow->push({
+                            EAGLE_CAPTURE_RECORD_FRAME,
+                            frame_index,
+                            std::vector<int16_t>(record.pcm, record.pcm + capture.frame_length),
+                            scores,
+                            {}});
+                }
+
+                latencies_usec.push_back(usec_between(due, after));
+                process_usec.push_back(usec_between(before, after));
+                fprintf(output_file,
+                        "%llu,%llu,%.1f,%.1f",
+                        static_cast<unsigned long long>(frame_index++),
+                        static_cast<unsigned long long>(record.timestamp_usec),
+                        latencies_usec.back(),
+                        process_usec.back());
+                for (float score : scores) {
+                    fprintf(output_file, ",%.4f", score);
+                }
+                fprintf(output_file, "\n");
+                break;
+            }
+            case EAGLE_CAPTURE_RECORD_SCORES: {
+                // the live result of the frame replayed last, whose scores are still in `scores`
+                if (frame_index == 0) {
+                    break;
+                }
+                live_process_usec.push_back(static_cast<double>(record.process_usec));
+
+                double difference = (static_cast<size_t>(record.num_scores) == scores.size()) ? 0.0 : INFINITY;
+                for (size_t i = 0; (i < scores.size()) && (i < static_cast<size_t>(record.num_scores)); i++) {
+                    difference = std::max(difference, static_cast<double>(std::fabs(scores[i] - record.scores[i])));
+                }
+                if (difference > score_tolerance) {
+                    if (num_mismatches < MAX_REPORTED_MISMATCHES) {
+                        fprintf(stderr, "frame %llu: live scores", static_cast<unsigned long long>(frame_index - 1));
+                        for (int32_t i = 0; i < record.num_scores; i++) {
+                            fprintf(stderr, " %.4f", record.scores[i]);
+                        }
+                        fprintf(stderr, ", replayed scores");
+                        for (float score : scores) {
+                            fprintf(stderr, " %.4f", score);
+                        }
+                        fprintf(stderr, "\n");
+                    }
+                    num_mismatches++;
+                }
+                if (std::isfinite(difference)) {
+                    max_live_difference = std::max(max_live_difference, difference);
+                }
+                break;
+            }
+        }
+
+        eagle_capture_record_free(&record);
+    }
+    eagle_capture_close(&capture);
+
+    if (read_status == EAGLE_CAPTURE_READ_ERROR) {
+        fprintf(stderr,
+                "capture '%s' has a truncated or unknown record at byte %ld.\n",
+                capture_path,
+                capture.record_offset);
+        exit(EXIT_FAILURE);
+    }
+
+    if (output_file != stdout) {
+        fclose(output_file);
+    }
+
+    const double audio_sec = static_cast<double>(frame_index * static_cast<uint64_t>(capture.frame_length)) /
+                             static_cast<double>(capture.sample_rate);
+    fprintf(stderr,
+            "replayed %llu frames (%.1f s of audio) in %.1f s, latency p50 %.1f us p99 %.1f us, "
+            "process p50 %.1f us p99 %.1f us\n",
+            static_cast<unsigned long long>(frame_index),
+            audio_sec,
+            usec_between(start, clock::now()) / 1e6,
+            percentile(latencies_usec, 0.5),
+            percentile(latencies_usec, 0.99),
+            percentile(process_usec, 0.5),
+            percentile(process_usec, 0.99));
+    if (!live_process_usec.empty()) {
+        fprintf(stderr,
+                "live session: process p50 %.1f us p99 %.1f us, %llu of %llu frames differ from the replay by more "
+                "than %g (max difference %.4f)\n",
+                percentile(live_process_usec, 0.5),
+                percentile(live_process_usec, 0.99),
+                static_cast<unsigned long long>(num_mismatches),
+                static_cast<unsigned long long>(live_process_usec.size()),
+                score_tolerance,
+                max_live_difference);
+    }
+
+    if (shadow) {
+        shadow->finish();
+        fclose(shadow_output_file);
+        shadow->print_summary();
+    }
+
+    // a replay that disagrees with the live session fails, so that it can gate changes to the build or the model
+    return (num_mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
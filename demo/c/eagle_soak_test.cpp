@@ -0,0 +1,462 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <getopt.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pv_eagle.hpp"
+#include "pv_eagle_resources.hpp"
+
+// Streams synthetic audio through many Eagle instances for a long time while periodically resetting them, recreating
+// them with a different set of profiles and running enrollment sessions on the side. Resident memory, heap usage and
+// latency percentiles are sampled at a fixed interval. The first quarter of the run is treated as warm-up; the run fails
+// if memory keeps growing or latency drifts between the second and the last quarter.
+
+static struct option long_options[] = {
+        {"access_key",              required_argument, NULL, 'a'},
+        {"model_path",              required_argument, NULL, 'm'},
+        {"test",                    required_argument, NULL, 't'},
+        {"num_instances",           required_argument, NULL, 'i'},
+        {"duration_sec",            required_argument, NULL, 'd'},
+        {"sample_interval_sec",     required_argument, NULL, 's'},
+        {"reset_interval_sec",      required_argument, NULL, 'r'},
+        {"churn_interval_sec",      required_argument, NULL, 'c'},
+        {"max_rss_growth_mb",       required_argument, NULL, 'g'},
+        {"max_heap_growth_mb",      required_argument, NULL, 'H'},
+        {"max_latency_drift_ratio", required_argument, NULL, 'x'},
+        {NULL,                      0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY -t INPUT_PROFILE_PATH [-i NUM_INSTANCES -d DURATION_SEC "
+            "-s SAMPLE_INTERVAL_SEC -r RESET_INTERVAL_SEC -c CHURN_INTERVAL_SEC -g MAX_RSS_GROWTH_MB "
+            "-H MAX_HEAP_GROWTH_MB -x MAX_LATENCY_DRIFT_RATIO]\n",
+            program_name);
+}
+
+static const size_t MAX_LATENCY_USEC = 100000;
+
+struct latency_histogram {
+    std::mutex mutex;
+    std::vector<uint64_t> counts = std::vector<uint64_t>(MAX_LATENCY_USEC + 1, 0);
+};
+
+struct memory_sample {
+    double elapsed_sec;
+    double rss_mb;
+    double heap_mb;
+    double p50_usec;
+    double p99_usec;
+};
+
+static std::vector<uint8_t> read_profile(const char *input_profile_path) {
+    FILE *input_profile_file = fopen(input_profile_path, "rb");
+    if (!input_profile_file) {
+        fprintf(stderr, "failed to open speaker profile file at '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fseek(input_profile_file, 0, SEEK_END);
+    std::vector<uint8_t> profile(static_cast<size_t>(ftell(input_profile_file)));
+    rewind(input_profile_file);
+
+    const size_t num_bytes = fread(profile.data(), sizeof(uint8_t), profile.size(), input_profile_file);
+    fclose(input_profile_file);
+    if (num_bytes != profile.size()) {
+        fprintf(stderr, "failed to read speaker profile from '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    return profile;
+}
+
+static double rss_mb() {
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0.0;
+    }
+
+    long num_pages = 0;
+    long num_resident_pages = 0;
+    const int num_read = fscanf(statm, "%ld %ld", &num_pages, &num_resident_pages);
+    fclose(statm);
+    if (num_read != 2) {
+        return 0.0;
+    }
+
+    return (static_cast<double>(num_resident_pages) * static_cast<double>(sysconf(_SC_PAGESIZE))) / (1024.0 * 1024.0);
+}
+
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+
+static const bool IS_HEAP_MEASURED = true;
+
+#else
+
+static const bool IS_HEAP_MEASURED = false;
+
+#endif
+
+static double heap_mb() {
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+    const struct mallinfo2 info = mallinfo2();
+    return static_cast<double>(info.uordblks + info.hblkhd) / (1024.0 * 1024.0);
+#else
+    return 0.0;
+#endif
+}
+
+static double percentile(const std::vector<uint64_t> &counts, double fraction) {
+    uint64_t total = 0;
+    for (uint64_t count : counts) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        cumulative += counts[i];
+        if (cumulative >= rank) {
+            return static_cast<double>(i);
+        }
+    }
+    return static_cast<double>(counts.size() - 1);
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Deterministic mix of tones and noise, so that every run feeds the engine the same audio.
+static void synthesize_frame(int16_t *pcm, size_t frame_length, uint64_t frame_index, uint32_t *seed) {
+    const double two_pi = 6.283185307179586;
+    const double sample_rate = static_cast<double>(pv::eagle::sample_rate());
+    const double pitch_hz = 110.0 + static_cast<double>((frame_index / 64) % 16) * 15.0;
+
+    for (size_t i = 0; i < frame_length; i++) {
+        const double t = static_cast<double>((frame_index * frame_length) + i) / sample_rate;
+        *seed = (*seed * 1664525u) + 1013904223u;
+        const double noise = (static_cast<double>(*seed >> 16) / 32768.0) - 1.0;
+        const double sample = (0.3 * sin(two_pi * pitch_hz * t)) +
+                              (0.15 * sin(two_pi * 2.0 * pitch_hz * t)) +
+                              (0.05 * noise);
+        pcm[i] = static_cast<int16_t>(sample * 32767.0);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *input_profile_path = NULL;
+    int32_t num_instances = 0;
+    double duration_sec = 3600.0;
+    double sample_interval_sec = 10.0;
+    double reset_interval_sec = 30.0;
+    double churn_interval_sec = 120.0;
+    double max_rss_growth_mb = 16.0;
+    double max_heap_growth_mb = 8.0;
+    double max_latency_drift_ratio = 1.5;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:t:i:d:s:r:c:g:H:x:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 't':
+                input_profile_path = optarg;
+                break;
+            case 'i':
+                num_instances = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            case 'd':
+                duration_sec = strtod(optarg, NULL);
+                break;
+            case 's':
+                sample_interval_sec = strtod(optarg, NULL);
+                break;
+            case 'r':
+                reset_interval_sec = strtod(optarg, NULL);
+                break;
+            case 'c':
+                churn_interval_sec = strtod(optarg, NULL);
+                break;
+            case 'g':
+                max_rss_growth_mb = strtod(optarg, NULL);
+                break;
+            case 'H':
+                max_heap_growth_mb = strtod(optarg, NULL);
+                break;
+            case 'x':
+                max_latency_drift_ratio = strtod(optarg, NULL);
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!access_key || !model_path || !input_profile_path || (num_instances < 0) || (duration_sec <= 0.0) ||
+        (sample_interval_sec <= 0.0) || ((duration_sec / sample_interval_sec) < 8.0)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    // every recognizer keeps a thread busy, so by default there are as many as the CPU quota allows
+    const pv::eagle::ResourceLimits limits = pv::eagle::resource_limits();
+    if (num_instances == 0) {
+        num_instances = static_cast<int32_t>(pv::eagle::num_worker_threads(limits));
+    }
+    fprintf(stdout,
+            "cpu limit %.2f%s, %d instance(s)\n\n",
+            limits.cpus,
+            limits.is_cgroup_limited ? " (cgroup)" : "",
+            num_instances);
+
+    const std::vector<uint8_t> profile_bytes = read_profile(input_profile_path);
+
+    // recognizers alternate between one and `max_profiles` copies of the profile every churn interval
+    const size_t max_profiles = 4;
+    std::vector<pv::eagle::Profile> profiles;
+    for (size_t i = 0; i < max_profiles; i++) {
+        profiles.push_back(pv::eagle::Profile::from_bytes(profile_bytes));
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto seconds_since = [](clock::time_point since) {
+        return std::chrono::duration<double>(clock::now() - since).count();
+    };
+
+    std::atomic<bool> stop = false;
+    std::atomic<bool> failed = false;
+    std::vector<latency_histogram> histograms(num_instances);
+    std::vector<std::thread> threads;
+
+    for (int32_t i = 0; i < num_instances; i++) {
+        threads.emplace_back([&, i] {
+            const size_t frame_length = static_cast<size_t>(pv::eagle::Eagle::frame_length());
+            std::vector<int16_t> pcm(frame_length);
+            std::vector<float> scores(max_profiles);
+            uint32_t seed = 12345u + static_cast<uint32_t>(i);
+            uint64_t frame_index = 0;
+            size_t num_profiles = 1;
+
+            pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(
+                    access_key,
+                    model_path,
+                    pv::eagle::Span<const pv::eagle::Profile>(profiles.data(), num_profiles));
+            auto last_reset = clock::now();
+            auto last_churn = clock::now();
+
+            while (eagle && !stop) {
+                synthesize_frame(pcm.data(), frame_length, frame_index++, &seed);
+
+                const auto before = clock::now();
+                const pv::eagle::Expected<void> status = eagle->process(pcm, scores);
+                const auto after = clock::now();
+                if (!status) {
+                    fprintf(stderr, "failed to process audio with '%s'\n", status.error().message());
+                    failed = true;
+                    break;
+                }
+
+                const size_t latency_usec = static_cast<size_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(after - before).count());
+                {
+                    std::lock_guard<std::mutex> lock(histograms[i].mutex);
+                    histograms[i].counts[std::min(latency_usec, MAX_LATENCY_USEC)]++;
+                }
+
+                if (seconds_since(last_churn) >= churn_interval_sec) {
+                    num_profiles = (num_profiles == 1) ? max_profiles : 1;
+                    eagle = pv::eagle::Eagle::create(
+                            access_key,
+                            model_path,
+                            pv::eagle::Span<const pv::eagle::Profile>(profiles.data(), num_profiles));
+                    last_churn = clock::now();
+                    last_reset = last_churn;
+                } else if (seconds_since(last_reset) >= reset_interval_sec) {
+                    const pv::eagle::Expected<void> reset_status = eagle->reset();
+                    if (!reset_status) {
+                        fprintf(stderr, "failed to reset eagle with '%s'\n", reset_status.error().message());
+                        failed = true;
+                        break;
+                    }
+                    last_reset = clock::now();
+                }
+            }
+
+            if (!eagle) {
+                fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+                failed = true;
+            }
+        });
+    }
+
+    // enrollment sessions exercise the profiler's allocations alongside the recognizers
+    threads.emplace_back([&] {
+        pv::eagle::Expected<pv::eagle::EagleProfiler> profiler = pv::eagle::EagleProfiler::create(access_key, model_path);
+        if (!profiler) {
+            fprintf(stderr, "failed to create an instance of eagle profiler with '%s'\n", profiler.error().message());
+            failed = true;
+            return;
+        }
+
+        const size_t frame_length = static_cast<size_t>(pv::eagle::Eagle::frame_length());
+        const size_t num_samples = static_cast<size_t>(pv::eagle::sample_rate()) * 4;
+        std::vector<int16_t> pcm(num_samples);
+        uint32_t seed = 54321u;
+        uint64_t frame_index = 0;
+
+        while (!stop) {
+            for (size_t offset = 0; (offset + frame_length) <= num_samples; offset += frame_length) {
+                synthesize_frame(&pcm[offset], frame_length, frame_index++, &seed);
+            }
+
+            const pv::eagle::Expected<pv::eagle::EnrollResult> result = profiler->enroll(pcm);
+            if (!result) {
+                fprintf(stderr, "failed to enroll audio with '%s'\n", result.error().message());
+                failed = true;
+                return;
+            }
+            if (result->percentage >= 100.f) {
+                const pv::eagle::Expected<pv::eagle::Profile> profile = profiler->export_profile();
+                if (!profile) {
+                    fprintf(stderr, "failed to export speaker profile with '%s'\n", profile.error().message());
+                    failed = true;
+                    return;
+                }
+                const pv::eagle::Expected<void> reset_status = profiler->reset();
+                if (!reset_status) {
+                    fprintf(stderr, "failed to reset eagle profiler with '%s'\n", reset_status.error().message());
+                    failed = true;
+                    return;
+                }
+            }
+
+            const auto resume = clock::now() + std::chrono::duration<double>(churn_interval_sec / 4.0);
+            while (!stop && (clock::now() < resume)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    });
+
+    fprintf(stdout, "%10s %10s %10s %10s %10s\n", "time (s)", "rss (MB)", "heap (MB)", "p50 (us)", "p99 (us)");
+
+    std::vector<memory_sample> samples;
+    std::vector<uint64_t> interval_counts(MAX_LATENCY_USEC + 1);
+    while (!failed && (seconds_since(start) < duration_sec)) {
+        const auto next = start + std::chrono::duration<double>(sample_interval_sec * (samples.size() + 1));
+        while (!failed && (clock::now() < next)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        std::fill(interval_counts.begin(), interval_counts.end(), 0);
+        for (latency_histogram &histogram : histograms) {
+            std::lock_guard<std::mutex> lock(histogram.mutex);
+            for (size_t i = 0; i <= MAX_LATENCY_USEC; i++) {
+                interval_counts[i] += histogram.counts[i];
+                histogram.counts[i] = 0;
+            }
+        }
+
+        const memory_sample sample = {
+                seconds_since(start),
+                rss_mb(),
+                heap_mb(),
+                percentile(interval_counts, 0.50),
+                percentile(interval_counts, 0.99),
+        };
+        samples.push_back(sample);
+        fprintf(stdout,
+                "%10.0f %10.2f %10.2f %10.0f %10.0f\n",
+                sample.elapsed_sec,
+                sample.rss_mb,
+                sample.heap_mb,
+                sample.p50_usec,
+                sample.p99_usec);
+        fflush(stdout);
+    }
+
+    stop = true;
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (failed) {
+        exit(EXIT_FAILURE);
+    }
+
+    // the first quarter is discarded as warm-up, then the second quarter is compared with the last one
+    const size_t quarter = samples.size() / 4;
+    double baseline_rss_mb = 0.0;
+    double final_rss_mb = samples.back().rss_mb;
+    double baseline_heap_mb = 0.0;
+    double final_heap_mb = samples.back().heap_mb;
+    std::vector<double> baseline_p99;
+    std::vector<double> final_p99;
+    for (size_t i = quarter; i < (2 * quarter); i++) {
+        baseline_rss_mb = std::max(baseline_rss_mb, samples[i].rss_mb);
+        baseline_heap_mb = std::max(baseline_heap_mb, samples[i].heap_mb);
+        baseline_p99.push_back(samples[i].p99_usec);
+    }
+    for (size_t i = samples.size() - quarter; i < samples.size(); i++) {
+        final_rss_mb = std::min(final_rss_mb, samples[i].rss_mb);
+        final_heap_mb = std::min(final_heap_mb, samples[i].heap_mb);
+        final_p99.push_back(samples[i].p99_usec);
+    }
+
+    const double rss_growth_mb = final_rss_mb - baseline_rss_mb;
+    const double heap_growth_mb = final_heap_mb - baseline_heap_mb;
+    const double latency_drift_ratio = median(final_p99) / std::max(median(baseline_p99), 1.0);
+
+    fprintf(stdout, "\nrss growth          : %.2f MB (limit %.2f MB)\n", rss_growth_mb, max_rss_growth_mb);
+    if (IS_HEAP_MEASURED) {
+        fprintf(stdout, "heap growth         : %.2f MB (limit %.2f MB)\n", heap_growth_mb, max_heap_growth_mb);
+    } else {
+        fprintf(stdout, "heap growth         : n/a\n");
+    }
+    fprintf(stdout, "p99 latency drift   : %.2fx (limit %.2fx)\n", latency_drift_ratio, max_latency_drift_ratio);
+
+    if (rss_growth_mb > max_rss_growth_mb) {
+        fprintf(stderr, "resident memory kept growing over the run\n");
+        exit(EXIT_FAILURE);
+    }
+    if (IS_HEAP_MEASURED && (heap_growth_mb > max_heap_growth_mb)) {
+        fprintf(stderr, "heap usage kept growing over the run\n");
+        exit(EXIT_FAILURE);
+    }
+    if (latency_drift_ratio > max_latency_drift_ratio) {
+        fprintf(stderr, "p99 latency drifted over the run\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,328 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define DR_WAV_IMPLEMENTATION
+
+#include "dr_wav.h"
+
+#include "pv_eagle.hpp"
+
+#include "perf_counters.h"
+
+// Compares the per-call cost of `pv_eagle_process()` and `pv_eagle_profiler_enroll()` against the same calls made
+// through `pv_eagle.hpp`. Raw and wrapped calls are interleaved so that both see the same cache and frequency state.
+// Hardware counters are collected around both where the platform provides them.
+
+static struct option long_options[] = {
+        {"access_key",     required_argument, NULL, 'a'},
+        {"model_path",     required_argument, NULL, 'm'},
+        {"test",           required_argument, NULL, 't'},
+        {"num_iterations", required_argument, NULL, 'n'},
+        {NULL,             0,                 NULL, 0},
+};
+
+static void print_usage(const char *program_name) {
+    fprintf(stdout,
+            "Usage: %s -m MODEL_PATH -a ACCESS_KEY -t INPUT_PROFILE_PATH [-n NUM_ITERATIONS] WAV_AUDIO_PATH\n",
+            program_name);
+}
+
+static double elapsed_nsec(
+        std::chrono::steady_clock::time_point before,
+        std::chrono::steady_clock::time_point after) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+}
+
+static void print_stats(const char *name, std::vector<double> &samples_nsec) {
+    std::sort(samples_nsec.begin(), samples_nsec.end());
+
+    double sum = 0.0;
+    for (double sample : samples_nsec) {
+        sum += sample;
+    }
+
+    const size_t n = samples_nsec.size();
+    fprintf(stdout,
+            "%-18s mean: %10.0f ns  p50: %10.0f ns  p99: %10.0f ns\n",
+            name,
+            sum / static_cast<double>(n),
+            samples_nsec[n / 2],
+            samples_nsec[std::min(n - 1, (n * 99) / 100)]);
+}
+
+static double mean(const std::vector<double> &samples_nsec) {
+    double sum = 0.0;
+    for (double sample : samples_nsec) {
+        sum += sample;
+    }
+    return sum / static_cast<double>(samples_nsec.size());
+}
+
+static std::vector<int16_t> read_wav(const char *wav_audio_path) {
+    drwav wav_audio_file;
+    if (!drwav_init_file(&wav_audio_file, wav_audio_path, NULL)) {
+        fprintf(stderr, "failed to open wav file at '%s'.\n", wav_audio_path);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((wav_audio_file.sampleRate != static_cast<uint32_t>(pv::eagle::sample_rate())) ||
+        (wav_audio_file.bitsPerSample != 16) ||
+        (wav_audio_file.channels != 1)) {
+        fprintf(stderr, "audio should be single-channel 16-bit PCM at %d Hz.\n", pv::eagle::sample_rate());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<int16_t> pcm(wav_audio_file.totalPCMFrameCount);
+    drwav_read_pcm_frames_s16(&wav_audio_file, pcm.size(), pcm.data());
+    drwav_uninit(&wav_audio_file);
+
+    return pcm;
+}
+
+static std::vector<uint8_t> read_profile(const char *input_profile_path) {
+    FILE *input_profile_file = fopen(input_profile_path, "rb");
+    if (!input_profile_file) {
+        fprintf(stderr, "failed to open speaker profile file at '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fseek(input_profile_file, 0, SEEK_END);
+    std::vector<uint8_t> profile(static_cast<size_t>(ftell(input_profile_file)));
+    rewind(input_profile_file);
+
+    const size_t num_bytes = fread(profile.data(), sizeof(uint8_t), profile.size(), input_profile_file);
+    fclose(input_profile_file);
+    if (num_bytes != profile.size()) {
+        fprintf(stderr, "failed to read speaker profile from '%s'.\n", input_profile_path);
+        exit(EXIT_FAILURE);
+    }
+
+    return profile;
+}
+
+static void benchmark_process(
+        const char *access_key,
+        const char *model_path,
+        const std::vector<uint8_t> &profile_bytes,
+        const std::vector<int16_t> &pcm,
+        int32_t num_iterations) {
+    const void *raw_profiles[] = {profile_bytes.data()};
+    pv_eagle_t *raw_eagle = NULL;
+    pv_status_t status = pv_eagle_init(access_key, model_path, 1, raw_profiles, &raw_eagle);
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "failed to create an instance of eagle with '%s'\n", pv_status_to_string(status));
+        exit(EXIT_FAILURE);
+    }
+
+    const pv::eagle::Profile profiles[] = {pv::eagle::Profile::from_bytes(profile_bytes)};
+    pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(access_key, model_path, profiles);
+    if (!eagle) {
+        fprintf(stderr, "failed to create an instance of eagle with '%s'\n", eagle.error().message());
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t frame_length = static_cast<size_t>(pv_eagle_frame_length());
+    const size_t num_frames = pcm.size() / frame_length;
+
+    std::vector<double> raw_nsec;
+    std::vector<double> wrapper_nsec;
+    raw_nsec.reserve(num_frames * num_iterations);
+    wrapper_nsec.reserve(num_frames * num_iterations);
+
+    perf_counters_t raw_counters;
+    perf_counters_open(&raw_counters);
+    perf_counters_t wrapper_counters;
+    perf_counters_open(&wrapper_counters);
+
+    float raw_score = 0.f;
+    float wrapper_score = 0.f;
+    for (int32_t i = 0; i < num_iterations; i++) {
+        for (size_t j = 0; j < num_frames; j++) {
+            const int16_t *frame = &pcm[j * frame_length];
+
+            const bool raw_first = ((i + j) % 2) == 0;
+            for (int32_t k = 0; k < 2; k++) {
+                if ((k == 0) == raw_first) {
+                    perf_counters_start(&raw_counters);
+                    const auto before = std::chrono::steady_clock::now();
+                    status = pv_eagle_process(raw_eagle, frame, &raw_score);
+                    const auto after = std::chrono::steady_clock::now();
+                    perf_counters_stop(&raw_counters);
+                    if (status != PV_STATUS_SUCCESS) {
+                        fprintf(stderr, "failed to process audio with '%s'\n", pv_status_to_string(status));
+                        exit(EXIT_FAILURE);
+                    }
+                    raw_nsec.push_back(elapsed_nsec(before, after));
+                } else {
+                    perf_counters_start(&wrapper_counters);
+                    const auto before = std::chrono::steady_clock::now();
+                    const pv::eagle::Expected<void> result = eagle->process(
+                            pv::eagle::Span<const int16_t>(frame, frame_length),
+                            pv::eagle::Span<float>(&wrapper_score, 1));
+                    const auto after = std::chrono::steady_clock::now();
+                    perf_counters_stop(&wrapper_counters);
+                    if (!result) {
+                        fprintf(stderr, "failed to process audio with '%s'\n", result.error().message());
+                        exit(EXIT_FAILURE);
+                    }
+                    wrapper_nsec.push_back(elapsed_nsec(before, after));
+                }
+            }
+        }
+
+        pv_eagle_reset(raw_eagle);
+        eagle->reset();
+    }
+
+    pv_eagle_delete(raw_eagle);
+
+    fprintf(stdout, "pv_eagle_process() over %zu frames\n", raw_nsec.size());
+    print_stats("raw", raw_nsec);
+    print_stats("wrapper", wrapper_nsec);
+    fprintf(stdout, "wrapper overhead   %+.2f%%\n", 100.0 * (mean(wrapper_nsec) - mean(raw_nsec)) / mean(raw_nsec));
+
+    const double audio_sec = static_cast<double>(raw_nsec.size() * frame_length) / pv_sample_rate();
+    perf_counters_print(&raw_counters, "raw pv_eagle_process()", static_cast<double>(raw_nsec.size()), "frame", audio_sec);
+    perf_counters_print(&wrapper_counters, "wrapper process()", static_cast<double>(wrapper_nsec.size()), "frame", audio_sec);
+    perf_counters_close(&raw_counters);
+    perf_counters_close(&wrapper_counters);
+    fprintf(stdout, "\n");
+}
+
+static void benchmark_enroll(
+        const char *access_key,
+        const char *model_path,
+        const std::vector<int16_t> &pcm,
+        int32_t num_iterations) {
+    pv_eagle_profiler_t *raw_profiler = NULL;
+    pv_status_t status = pv_eagle_profiler_init(access_key, model_path, &raw_profiler);
+    if (status != PV_STATUS_SUCCESS) {
+        fprintf(stderr, "failed to create an instance of eagle profiler with '%s'\n", pv_status_to_string(status));
+        exit(EXIT_FAILURE);
+    }
+
+    pv::eagle::Expected<pv::eagle::EagleProfiler> profiler = pv::eagle::EagleProfiler::create(access_key, model_path);
+    if (!profiler) {
+        fprintf(stderr, "failed to create an instance of eagle profiler with '%s'\n", profiler.error().message());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<double> raw_nsec;
+    std::vector<double> wrapper_nsec;
+
+    perf_counters_t raw_counters;
+    perf_counters_open(&raw_counters);
+    perf_counters_t wrapper_counters;
+    perf_counters_open(&wrapper_counters);
+
+    for (int32_t i = 0; i < num_iterations; i++) {
+        pv_eagle_profiler_reset(raw_profiler);
+        profiler->reset();
+
+        const bool raw_first = (i % 2) == 0;
+        for (int32_t k = 0; k < 2; k++) {
+            if ((k == 0) == raw_first) {
+                pv_eagle_profiler_enroll_feedback_t feedback = PV_EAGLE_PROFILER_ENROLL_FEEDBACK_AUDIO_OK;
+                float percentage = 0.f;
+
+                perf_counters_start(&raw_counters);
+                const auto before = std::chrono::steady_clock::now();
+                status = pv_eagle_profiler_enroll(
+                        raw_profiler,
+                        pcm.data(),
+                        static_cast<int32_t>(pcm.size()),
+                        &feedback,
+                        &percentage);
+                const auto after = std::chrono::steady_clock::now();
+                perf_counters_stop(&raw_counters);
+                if (status != PV_STATUS_SUCCESS) {
+                    fprintf(stderr, "failed to enroll audio with '%s'\n", pv_status_to_string(status));
+                    exit(EXIT_FAILURE);
+                }
+                raw_nsec.push_back(elapsed_nsec(before, after));
+            } else {
+                perf_counters_start(&wrapper_counters);
+                const auto before = std::chrono::steady_clock::now();
+                const pv::eagle::Expected<pv::eagle::EnrollResult> result = profiler->enroll(pcm);
+                const auto after = std::chrono::steady_clock::now();
+                perf_counters_stop(&wrapper_counters);
+                if (!result) {
+                    fprintf(stderr, "failed to enroll audio with '%s'\n", result.error().message());
+                    exit(EXIT_FAILURE);
+                }
+                wrapper_nsec.push_back(elapsed_nsec(before, after));
+            }
+        }
+    }
+
+    pv_eagle_profiler_delete(raw_profiler);
+
+    fprintf(stdout, "pv_eagle_profiler_enroll() over %zu calls\n", raw_nsec.size());
+    print_stats("raw", raw_nsec);
+    print_stats("wrapper", wrapper_nsec);
+    fprintf(stdout, "wrapper overhead   %+.2f%%\n", 100.0 * (mean(wrapper_nsec) - mean(raw_nsec)) / mean(raw_nsec));
+
+    const double audio_sec = static_cast<double>(raw_nsec.size() * pcm.size()) / pv_sample_rate();
+    perf_counters_print(&raw_counters, "raw pv_eagle_profiler_enroll()", static_cast<double>(raw_nsec.size()), "call", audio_sec);
+    perf_counters_print(&wrapper_counters, "wrapper enroll()", static_cast<double>(wrapper_nsec.size()), "call", audio_sec);
+    perf_counters_close(&raw_counters);
+    perf_counters_close(&wrapper_counters);
+}
+
+int main(int argc, char *argv[]) {
+    const char *access_key = NULL;
+    const char *model_path = NULL;
+    const char *input_profile_path = NULL;
+    int32_t num_iterations = 10;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:m:t:n:", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'a':
+                access_key = optarg;
+                break;
+            case 'm':
+                model_path = optarg;
+                break;
+            case 't':
+                input_profile_path = optarg;
+                break;
+            case 'n':
+                num_iterations = static_cast<int32_t>(strtol(optarg, NULL, 10));
+                break;
+            default:
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!access_key || !model_path || !input_profile_path || (num_iterations < 1) || ((argc - optind) != 1)) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(stdout, "v%s\n\n", pv::eagle::version());
+
+    const std::vector<int16_t> pcm = read_wav(argv[optind]);
+    const std::vector<uint8_t> profile_bytes = read_profile(input_profile_path);
+
+    benchmark_process(access_key, model_path, profile_bytes, pcm, num_iterations);
+    benchmark_enroll(access_key, model_path, pcm, num_iterations);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+/**
+ * Hardware performance counters of the calling thread, read through `perf_event_open()` on Linux. Counters the kernel
+ * or the CPU does not provide (e.g. inside most VMs, or with `perf_event_paranoid` > 2) are reported as unavailable
+ * and everything else keeps working. Only user-space events are counted.
+ */
+
+typedef enum {
+    PERF_COUNTER_CYCLES = 0,
+    PERF_COUNTER_INSTRUCTIONS,
+    PERF_COUNTER_LLC_MISSES,
+    PERF_COUNTER_DTLB_MISSES,
+    PERF_COUNTER_BRANCH_MISSES,
+    PERF_COUNTER_NUM,
+} perf_counter_t;
+
+typedef struct {
+    int fds[PERF_COUNTER_NUM];
+    uint64_t values[PERF_COUNTER_NUM];
+    uint64_t start_time_enabled[PERF_COUNTER_NUM];
+    uint64_t start_time_running[PERF_COUNTER_NUM];
+} perf_counters_t;
+
+static const char *PERF_COUNTER_NAMES[PERF_COUNTER_NUM] = {
+        "cycles",
+        "instructions",
+        "llc-misses",
+        "dtlb-misses",
+        "branch-misses",
+};
+
+/**
+ * Opens the counters for the calling thread. They start disabled and at zero.
+ *
+ * @return `true` if at least one counter is available.
+ */
+static inline bool perf_counters_open(perf_counters_t *counters) {
+    memset(counters->values, 0, sizeof(counters->values));
+    memset(counters->start_time_enabled, 0, sizeof(counters->start_time_enabled));
+    memset(counters->start_time_running, 0, sizeof(counters->start_time_running));
+    bool is_any_open = false;
+
+#if defined(__linux__)
+
+    const uint32_t types[PERF_COUNTER_NUM] = {
+            PERF_TYPE_HARDWARE,
+            PERF_TYPE_HARDWARE,
+            PERF_TYPE_HARDWARE,
+            PERF_TYPE_HW_CACHE,
+            PERF_TYPE_HARDWARE,
+    };
+    const uint64_t configs[PERF_COUNTER_NUM] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[i];
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fds[i] = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        is_any_open |= (counters->fds[i] >= 0);
+    }
+
+#else
+
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        counters->fds[i] = -1;
+    }
+
+#endif
+
+    return is_any_open;
+}
+
+static inline void perf_counters_close(perf_counters_t *counters) {
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (counters->fds[i] >= 0) {
+#if defined(__linux__)
+            close(counters->fds[i]);
+#endif
+            counters->fds[i] = -1;
+        }
+    }
+}
+
+static inline bool perf_counters_is_available(const perf_counters_t *counters, perf_counter_t counter) {
+    return counters->fds[counter] >= 0;
+}
+
+/**
+ * Starts counting from zero. Pair with `perf_counters_stop()` around the region of interest.
+ */
+static inline void perf_counters_start(perf_counters_t *counters) {
+#if defined(__linux__)
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+
+            // resetting clears the count but not the enabled and running times, which keep accumulating over every
+            // interval, so they are recorded here and `perf_counters_stop()` scales by the difference
+            uint64_t data[3] = {0, 0, 0};
+            if (read(counters->fds[i], data, sizeof(data)) == (ssize_t) sizeof(data)) {
+                counters->start_time_enabled[i] = data[1];
+                counters->start_time_running[i] = data[2];
+            }
+
+            ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#else
+    (void) counters;
+#endif
+}
+
+/**
+ * Stops counting and adds the counts since `perf_counters_start()` to `counters->values`, scaled up if the kernel had
+ * to multiplex the counters during that interval.
+ */
+static inline void perf_counters_stop(perf_counters_t *counters) {
+#if defined(__linux__)
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        uint64_t data[3] = {0, 0, 0};
+        if ((counters->fds[i] >= 0) && (read(counters->fds[i], data, sizeof(data)) == (ssize_t) sizeof(data))) {
+            const uint64_t value = data[0];
+            const uint64_t time_enabled = data[1] - counters->start_time_enabled[i];
+            const uint64_t time_running = data[2] - counters->start_time_running[i];
+            counters->values[i] += ((time_running > 0) && (time_running < time_enabled)) ?
+                                           (uint64_t) ((double) value * ((double) time_enabled / (double) time_running)) :
+                                           value;
+        }
+    }
+#else
+    (void) counters;
+#endif
+}
+
+/**
+ * Prints the accumulated counters normalized per unit of work (e.g. per frame) and per second of processed audio,
+ * followed by instructions per cycle.
+ *
+ * @param name Label of the measured stage.
+ * @param num_units Number of units of work covered by the counts.
+ * @param unit Name of the unit of work.
+ * @param audio_sec Seconds of audio covered by the counts.
+ */
+static inline void perf_counters_print(
+        const perf_counters_t *counters,
+        const char *name,
+        double num_units,
+        const char *unit,
+        double audio_sec) {
+    fprintf(stdout, "%s hardware counters\n", name);
+    for (int32_t i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (!perf_counters_is_available(counters, (perf_counter_t) i)) {
+            fprintf(stdout, "  %-14s %16s\n", PERF_COUNTER_NAMES[i], "n/a");
+            continue;
+        }
+        fprintf(stdout,
+                "  %-14s %16.0f per %s %16.0f per audio second\n",
+                PERF_COUNTER_NAMES[i],
+                (double) counters->values[i] / num_units,
+                unit,
+                (double) counters->values[i] / audio_sec);
+    }
+
+    if (perf_counters_is_available(counters, PERF_COUNTER_CYCLES) &&
+        perf_counters_is_available(counters, PERF_COUNTER_INSTRUCTIONS) &&
+        (counters->values[PERF_COUNTER_CYCLES] > 0)) {
+        fprintf(stdout,
+                "  %-14s %16.2f\n",
+                "ipc",
+                (double) counters->values[PERF_COUNTER_INSTRUCTIONS] / (double) counters->values[PERF_COUNTER_CYCLES]);
+    }
+}
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,40 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+// Minimal assertions for the header tests. A failed check is reported and counted, and the test binary exits with a
+// non-zero status if any check failed.
+
+static int num_failed_checks = 0;
+
+#define CHECK(condition)                                                                                             \
+    do {                                                                                                             \
+        if (!(condition)) {                                                                                          \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                            \
+            num_failed_checks++;                                                                                     \
+        }                                                                                                            \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    CHECK((((actual) - (expected)) <= (tolerance)) && (((expected) - (actual)) <= (tolerance)))
+
+#define RUN_TEST(test)                                                                                               \
+    do {                                                                                                             \
+        const int num_failed_before = num_failed_checks;                                                             \
+        test();                                                                                                      \
+        fprintf(stdout, "%s %s\n", (num_failed_checks == num_failed_before) ? "[PASS]" : "[FAIL]", #test);           \
+    } while (0)
+
+#endif // CHECK_H
@@ -0,0 +1,255 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pv_eagle_stub.h"
+
+#define MAX_SCORES (1024)
+
+struct pv_eagle {
+    int32_t num_speakers;
+};
+
+struct pv_eagle_profiler {
+    float percentage;
+};
+
+static pv_status_t init_status = PV_STATUS_SUCCESS;
+static int32_t init_delay_ms = 0;
+static pv_status_t process_status = PV_STATUS_SUCCESS;
+static float scores_sequence[MAX_SCORES];
+static int32_t num_scores = 0;
+static int64_t num_processed = 0;
+static int32_t num_objects = 0;
+
+void pv_eagle_stub_reset(void) {
+    init_status = PV_STATUS_SUCCESS;
+    init_delay_ms = 0;
+    process_status = PV_STATUS_SUCCESS;
+    num_scores = 0;
+    num_processed = 0;
+}
+
+void pv_eagle_stub_set_init_status(pv_status_t status) {
+    init_status = status;
+}
+
+void pv_eagle_stub_set_init_delay_ms(int32_t delay_ms) {
+    init_delay_ms = delay_ms;
+}
+
+void pv_eagle_stub_set_process_status(pv_status_t status) {
+    process_status = status;
+}
+
+void pv_eagle_stub_set_scores(const float *scores, int32_t length) {
+    num_scores = (length < MAX_SCORES) ? length : MAX_SCORES;
+    memcpy(scores_sequence, scores, (size_t) num_scores * sizeof(float));
+}
+
+int64_t pv_eagle_stub_num_processed(void) {
+    return num_processed;
+}
+
+int32_t pv_eagle_stub_num_objects(void) {
+    return num_objects;
+}
+
+int32_t pv_sample_rate(void) {
+    return 16000;
+}
+
+const char *pv_status_to_string(pv_status_t status) {
+    static const char *const STRINGS[] = {
+            "SUCCESS",
+            "OUT_OF_MEMORY",
+            "IO_ERROR",
+            "INVALID_ARGUMENT",
+            "STOP_ITERATION",
+            "KEY_ERROR",
+            "INVALID_STATE",
+            "RUNTIME_ERROR",
+            "ACTIVATION_ERROR",
+            "ACTIVATION_LIMIT_REACHED",
+            "ACTIVATION_THROTTLED",
+            "ACTIVATION_REFUSED",
+    };
+
+    if ((status < PV_STATUS_SUCCESS) || (status > PV_STATUS_ACTIVATION_REFUSED)) {
+        return NULL;
+    }
+    return STRINGS[status];
+}
+
+pv_status_t pv_eagle_profiler_init(
+        const char *access_key,
+        const char *model_path,
+        pv_eagle_profiler_t **object) {
+    if (!access_key || !model_path || !object) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    if (init_status != PV_STATUS_SUCCESS) {
+        return init_status;
+    }
+    *object = calloc(1, sizeof(pv_eagle_profiler_t));
+    if (!*object) {
+        return PV_STATUS_OUT_OF_MEMORY;
+    }
+    num_objects++;
+    return PV_STATUS_SUCCESS;
+}
+
+void pv_eagle_profiler_delete(pv_eagle_profiler_t *object) {
+    if (object) {
+        free(object);
+        num_objects--;
+    }
+}
+
+const char *pv_eagle_profiler_enroll_feedback_to_string(pv_eagle_profiler_enroll_feedback_t feedback) {
+    (void) feedback;
+    return "AUDIO_OK";
+}
+
+pv_status_t pv_eagle_profiler_enroll(
+        pv_eagle_profiler_t *object,
+        const int16_t *pcm,
+        int32_t num_samples,
+        pv_eagle_profiler_enroll_feedback_t *feedback,
+        float *percentage) {
+    if (!object || !pcm || !feedback || !percentage) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    if (num_samples < PV_EAGLE_STUB_FRAME_LENGTH) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    object->percentage = (object->percentage + 50.f < 100.f) ? (object->percentage + 50.f) : 100.f;
+    *feedback = PV_EAGLE_PROFILER_ENROLL_FEEDBACK_AUDIO_OK;
+    *percentage = object->percentage;
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_profiler_enroll_min_audio_length_samples(
+        const pv_eagle_profiler_t *object,
+        int32_t *num_samples) {
+    if (!object || !num_samples) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    *num_samples = PV_EAGLE_STUB_FRAME_LENGTH;
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_profiler_export(const pv_eagle_profiler_t *object, void *speaker_profile) {
+    if (!object || !speaker_profile) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    if (object->percentage < 100.f) {
+        return PV_STATUS_INVALID_STATE;
+    }
+    for (int32_t i = 0; i < PV_EAGLE_STUB_PROFILE_SIZE; i++) {
+        ((uint8_t *) speaker_profile)[i] = (uint8_t) i;
+    }
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_profiler_export_size(const pv_eagle_profiler_t *object, int32_t *speaker_profile_size_bytes) {
+    if (!object || !speaker_profile_size_bytes) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    *speaker_profile_size_bytes = PV_EAGLE_STUB_PROFILE_SIZE;
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_profiler_reset(pv_eagle_profiler_t *object) {
+    if (!object) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    object->percentage = 0.f;
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_init(
+        const char *access_key,
+        const char *model_path,
+        int32_t num_speakers,
+        const void *const *speaker_profiles,
+        pv_eagle_t **object) {
+    if (init_delay_ms > 0) {
+        const struct timespec delay = {init_delay_ms / 1000, (init_delay_ms % 1000) * 1000000L};
+        nanosleep(&delay, NULL);
+    }
+
+    if (!access_key || !model_path || (num_speakers < 1) || !speaker_profiles || !object) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    for (int32_t i = 0; i < num_speakers; i++) {
+        if (!speaker_profiles[i]) {
+            return PV_STATUS_INVALID_ARGUMENT;
+        }
+    }
+    if (init_status != PV_STATUS_SUCCESS) {
+        return init_status;
+    }
+
+    *object = calloc(1, sizeof(pv_eagle_t));
+    if (!*object) {
+        return PV_STATUS_OUT_OF_MEMORY;
+    }
+    (*object)->num_speakers = num_speakers;
+    num_objects++;
+    return PV_STATUS_SUCCESS;
+}
+
+void pv_eagle_delete(pv_eagle_t *object) {
+    if (object) {
+        free(object);
+        num_objects--;
+    }
+}
+
+pv_status_t pv_eagle_process(pv_eagle_t *object, const int16_t *pcm, float *scores) {
+    if (!object || !pcm || !scores) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    if (process_status != PV_STATUS_SUCCESS) {
+        return process_status;
+    }
+
+    float score = 0.f;
+    if (num_scores > 0) {
+        score = scores_sequence[(num_processed < num_scores) ? num_processed : (num_scores - 1)];
+    }
+    for (int32_t i = 0; i < object->num_speakers; i++) {
+        scores[i] = score;
+    }
+    num_processed++;
+    return PV_STATUS_SUCCESS;
+}
+
+pv_status_t pv_eagle_reset(pv_eagle_t *object) {
+    if (!object) {
+        return PV_STATUS_INVALID_ARGUMENT;
+    }
+    return PV_STATUS_SUCCESS;
+}
+
+int32_t pv_eagle_frame_length(void) {
+    return PV_EAGLE_STUB_FRAME_LENGTH;
+}
+
+const char *pv_eagle_version(void) {
+    return "stub";
+}
@@ -0,0 +1,73 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_STUB_H
+#define PV_EAGLE_STUB_H
+
+#include <stdint.h>
+
+#include "pv_eagle.h"
+
+#ifdef __cplusplus
+
+extern "C" {
+
+#endif
+
+// Scripted stand-in for the Eagle library, used to test the C++ headers without the engine or an AccessKey. Every
+// speaker is given the same score; the scores follow the sequence set with `pv_eagle_stub_set_scores()` and the last
+// one repeats once it runs out.
+
+#define PV_EAGLE_STUB_FRAME_LENGTH (512)
+#define PV_EAGLE_STUB_PROFILE_SIZE (64)
+
+/**
+ * Restores the default behaviour: every call succeeds, initialization does not block and every score is 0.
+ */
+void pv_eagle_stub_reset(void);
+
+/**
+ * Status returned by `pv_eagle_init()` and `pv_eagle_profiler_init()`.
+ */
+void pv_eagle_stub_set_init_status(pv_status_t status);
+
+/**
+ * Time `pv_eagle_init()` blocks for, in milliseconds.
+ */
+void pv_eagle_stub_set_init_delay_ms(int32_t delay_ms);
+
+/**
+ * Status returned by `pv_eagle_process()`.
+ */
+void pv_eagle_stub_set_process_status(pv_status_t status);
+
+/**
+ * Sequence of scores returned by consecutive `pv_eagle_process()` calls. The scores are copied.
+ */
+void pv_eagle_stub_set_scores(const float *scores, int32_t num_scores);
+
+/**
+ * Number of successful `pv_eagle_process()` calls since the last `pv_eagle_stub_reset()`.
+ */
+int64_t pv_eagle_stub_num_processed(void);
+
+/**
+ * Number of live `pv_eagle_t` and `pv_eagle_profiler_t` objects.
+ */
+int32_t pv_eagle_stub_num_objects(void);
+
+#ifdef __cplusplus
+
+}
+
+#endif
+
+#endif // PV_EAGLE_STUB_H
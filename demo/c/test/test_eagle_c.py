@@ -13,6 +13,7 @@ import os.path
 import subprocess
 import sys
 import unittest
+import wave
 
 
 class EagleCTestCase(unittest.TestCase):
@@ -49,17 +50,26 @@ class EagleCTestCase(unittest.TestCase):
         return [os.path.join(self._root_dir, 'resources/audio_samples', audio_file_name)
                 for audio_file_name in audio_file_names]
 
-    def run_eagle(self, audio_file_name, is_enroll=False):
+    def run_eagle(self, audio_file_name, is_enroll=False, raw_pcm=None):
         args = [
             os.path.join(os.path.dirname(__file__), "../build/eagle_demo_file"),
             "-a", self._access_key,
             "-l", self._get_library_file(),
             "-m", self._get_model_path(),
             "-e" if is_enroll else "-t", "tmp_profile.egl",
-            *self._get_audio_file(audio_file_name),
         ]
-        process = subprocess.Popen(args, stderr=subprocess.PIPE, stdout=subprocess.PIPE, encoding='utf-8')
-        stdout, stderr = process.communicate()
+        if raw_pcm is None:
+            args.extend(self._get_audio_file(audio_file_name))
+        else:
+            args.extend(["-r", "-"])
+        process = subprocess.Popen(
+            args,
+            stdin=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            stdout=subprocess.PIPE)
+        stdout, stderr = process.communicate(input=raw_pcm)
+        stdout = stdout.decode('utf-8')
+        stderr = stderr.decode('utf-8')
         self.assertEqual(process.poll(), 0)
         self.assertEqual(stderr, '')
         self.assertTrue("real time factor" in stdout)
@@ -70,6 +80,11 @@ class EagleCTestCase(unittest.TestCase):
     def test_eagle_test(self):
         self.run_eagle(["speaker_1_test_utt.wav"], is_enroll=False)
 
+    def test_eagle_test_raw_pcm(self):
+        with wave.open(self._get_audio_file(["speaker_1_test_utt.wav"])[0], 'rb') as f:
+            raw_pcm = f.readframes(f.getnframes())
+        self.run_eagle([], is_enroll=False, raw_pcm=raw_pcm)
+
 
 if __name__ == '__main__':
     if len(sys.argv) < 3 or len(sys.argv) > 4:
@@ -0,0 +1,199 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <array>
+#include <variant>
+#include <vector>
+
+#include "pv_eagle.hpp"
+
+#include "check.h"
+#include "pv_eagle_stub.h"
+
+// Tests `pv_eagle.hpp` against the scripted library in `pv_eagle_stub.c`.
+
+static const char *ACCESS_KEY = "access_key";
+static const char *MODEL_PATH = "eagle_params.pv";
+
+static pv::eagle::Profile enroll_profile() {
+    pv::eagle::Expected<pv::eagle::EagleProfiler> profiler = pv::eagle::EagleProfiler::create(ACCESS_KEY, MODEL_PATH);
+    CHECK(profiler.has_value());
+
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    for (int32_t i = 0; i < 2; i++) {
+        CHECK(profiler->enroll(pcm).has_value());
+    }
+
+    pv::eagle::Expected<pv::eagle::Profile> profile = profiler->export_profile();
+    CHECK(profile.has_value());
+    return std::move(profile).value();
+}
+
+static void test_span() {
+    std::vector<int16_t> vector = {1, 2, 3, 4};
+    const pv::eagle::Span<const int16_t> from_vector(vector);
+    CHECK(from_vector.data() == vector.data());
+    CHECK(from_vector.size() == 4);
+
+    float array[3] = {0.f, 1.f, 2.f};
+    const pv::eagle::Span<float> from_array(array);
+    CHECK(from_array.size() == 3);
+    from_array[1] = 5.f;
+    CHECK(array[1] == 5.f);
+
+    const pv::eagle::Span<const int16_t> middle = from_vector.subspan(1, 2);
+    CHECK((middle.size() == 2) && (middle[0] == 2) && (middle[1] == 3));
+
+    int32_t sum = 0;
+    for (int16_t sample : from_vector) {
+        sum += sample;
+    }
+    CHECK(sum == 10);
+
+    CHECK(pv::eagle::Span<const int16_t>().empty());
+}
+
+static void test_expected() {
+    pv::eagle::Expected<int32_t> value = 42;
+    CHECK(value.has_value());
+    CHECK(static_cast<bool>(value));
+    CHECK(value.value() == 42);
+    CHECK(*value == 42);
+    CHECK(value.error().status() == PV_STATUS_SUCCESS);
+
+    const pv::eagle::Expected<int32_t> error = pv::eagle::Error(PV_STATUS_IO_ERROR);
+    CHECK(!error.has_value());
+    CHECK(!error);
+    CHECK(error.error().status() == PV_STATUS_IO_ERROR);
+
+    bool is_thrown = false;
+    try {
+        (void) error.value();
+    } catch (const std::bad_variant_access &) {
+        is_thrown = true;
+    }
+    CHECK(is_thrown);
+
+    const pv::eagle::Expected<void> success;
+    CHECK(success.has_value());
+    const pv::eagle::Expected<void> failure = pv::eagle::Error(PV_STATUS_INVALID_STATE);
+    CHECK(!failure);
+    CHECK(failure.error().status() == PV_STATUS_INVALID_STATE);
+}
+
+static void test_profile_move() {
+    pv_eagle_stub_reset();
+
+    pv::eagle::Profile profile = enroll_profile();
+    CHECK(profile.size() == PV_EAGLE_STUB_PROFILE_SIZE);
+    CHECK(profile.bytes()[PV_EAGLE_STUB_PROFILE_SIZE - 1] == PV_EAGLE_STUB_PROFILE_SIZE - 1);
+
+    const void *data = profile.data();
+    pv::eagle::Profile moved(std::move(profile));
+    CHECK((moved.data() == data) && (moved.size() == PV_EAGLE_STUB_PROFILE_SIZE));
+    CHECK((profile.data() == nullptr) && (profile.size() == 0) && profile.bytes().empty());
+
+    pv::eagle::Profile assigned;
+    assigned = std::move(moved);
+    CHECK((assigned.data() == data) && (assigned.size() == PV_EAGLE_STUB_PROFILE_SIZE));
+    CHECK((moved.data() == nullptr) && (moved.size() == 0));
+
+    const pv::eagle::Profile copy = pv::eagle::Profile::from_bytes(assigned.bytes());
+    CHECK((copy.data() != assigned.data()) && (copy.size() == assigned.size()));
+    CHECK(memcmp(copy.data(), assigned.data(), assigned.size()) == 0);
+}
+
+static void test_eagle_move() {
+    pv_eagle_stub_reset();
+
+    const std::array<pv::eagle::Profile, 2> profiles = {enroll_profile(), enroll_profile()};
+    pv::eagle::Expected<pv::eagle::Eagle> created = pv::eagle::Eagle::create(ACCESS_KEY, MODEL_PATH, profiles);
+    CHECK(created.has_value());
+    CHECK(pv_eagle_stub_num_objects() == 1);
+
+    pv::eagle::Eagle eagle = std::move(created).value();
+    pv_eagle_t *handle = eagle.get();
+    CHECK(handle != nullptr);
+    CHECK(eagle.num_speakers() == 2);
+
+    pv::eagle::Eagle moved(std::move(eagle));
+    CHECK((moved.get() == handle) && (eagle.get() == nullptr));
+    CHECK(moved.num_speakers() == 2);
+    CHECK(pv_eagle_stub_num_objects() == 1);
+
+    const std::vector<int16_t> pcm(static_cast<size_t>(pv::eagle::Eagle::frame_length()), 0);
+    std::vector<float> scores(2, -1.f);
+    const float script[] = {0.25f};
+    pv_eagle_stub_set_scores(script, 1);
+    CHECK(moved.process(pcm, scores).has_value());
+    CHECK((scores[0] == 0.25f) && (scores[1] == 0.25f));
+}
+
+static void test_error_propagation() {
+    pv_eagle_stub_reset();
+
+    pv_eagle_stub_set_init_status(PV_STATUS_ACTIVATION_ERROR);
+    const pv::eagle::Expected<pv::eagle::EagleProfiler> profiler = pv::eagle::EagleProfiler::create(
+            ACCESS_KEY,
+            MODEL_PATH);
+    CHECK(!profiler);
+    CHECK(profiler.error().status() == PV_STATUS_ACTIVATION_ERROR);
+    CHECK(strcmp(profiler.error().message(), "ACTIVATION_ERROR") == 0);
+    pv_eagle_stub_set_init_status(PV_STATUS_SUCCESS);
+
+    pv::eagle::Expected<pv::eagle::EagleProfiler> incomplete = pv::eagle::EagleProfiler::create(ACCESS_KEY, MODEL_PATH);
+    CHECK(incomplete.has_value());
+    CHECK(incomplete->export_profile().error().status() == PV_STATUS_INVALID_STATE);
+    std::vector<uint8_t> too_small(PV_EAGLE_STUB_PROFILE_SIZE - 1);
+    CHECK(incomplete->export_to(too_small).error().status() == PV_STATUS_INVALID_ARGUMENT);
+
+    const pv::eagle::Expected<pv::eagle::Eagle> no_speakers = pv::eagle::Eagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            pv::eagle::Span<const pv::eagle::Profile>());
+    CHECK(no_speakers.error().status() == PV_STATUS_INVALID_ARGUMENT);
+
+    const pv::eagle::Profile profile = enroll_profile();
+    pv::eagle::Expected<pv::eagle::Eagle> eagle = pv::eagle::Eagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            pv::eagle::Span<const pv::eagle::Profile>(&profile, 1));
+    CHECK(eagle.has_value());
+
+    const std::vector<int16_t> short_frame(static_cast<size_t>(pv::eagle::Eagle::frame_length()) - 1, 0);
+    const std::vector<int16_t> frame(static_cast<size_t>(pv::eagle::Eagle::frame_length()), 0);
+    float score = 0.f;
+    std::vector<float> no_scores;
+    CHECK(eagle->process(short_frame, pv::eagle::Span<float>(&score, 1)).error().status() ==
+          PV_STATUS_INVALID_ARGUMENT);
+    CHECK(eagle->process(frame, no_scores).error().status() == PV_STATUS_INVALID_ARGUMENT);
+    CHECK(pv_eagle_stub_num_processed() == 0);
+
+    pv_eagle_stub_set_process_status(PV_STATUS_RUNTIME_ERROR);
+    CHECK(eagle->process(frame, pv::eagle::Span<float>(&score, 1)).error().status() == PV_STATUS_RUNTIME_ERROR);
+    pv_eagle_stub_set_process_status(PV_STATUS_SUCCESS);
+    CHECK(eagle->process(frame, pv::eagle::Span<float>(&score, 1)).has_value());
+}
+
+int main() {
+    RUN_TEST(test_span);
+    RUN_TEST(test_expected);
+    RUN_TEST(test_profile_move);
+    RUN_TEST(test_eagle_move);
+    RUN_TEST(test_error_propagation);
+
+    CHECK(pv_eagle_stub_num_objects() == 0);
+
+    return (num_failed_checks == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,194 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <poll.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <vector>
+
+#include "pv_eagle_async.hpp"
+
+#include "check.h"
+#include "pv_eagle_stub.h"
+
+// Tests `pv_eagle_async.hpp` against the scripted library in `pv_eagle_stub.c`. Initialization is slowed down so that
+// frames arrive while the engine is still loading.
+
+static const char *ACCESS_KEY = "access_key";
+static const char *MODEL_PATH = "eagle_params.pv";
+static const int32_t INIT_DELAY_MS = 200;
+
+static std::vector<pv::eagle::Profile> make_profiles() {
+    const std::vector<uint8_t> bytes(PV_EAGLE_STUB_PROFILE_SIZE, 1);
+    std::vector<pv::eagle::Profile> profiles;
+    profiles.push_back(pv::eagle::Profile::from_bytes(bytes));
+    return profiles;
+}
+
+static void test_buffers_until_ready() {
+    pv_eagle_stub_reset();
+    pv_eagle_stub_set_init_delay_ms(INIT_DELAY_MS);
+    const float script[] = {0.75f};
+    pv_eagle_stub_set_scores(script, 1);
+
+    std::atomic<int32_t> num_callbacks = 0;
+    std::atomic<bool> is_callback_success = false;
+    const std::vector<pv::eagle::Profile> profiles = make_profiles();
+    pv::eagle::Expected<std::unique_ptr<pv::eagle::AsyncEagle>> created = pv::eagle::AsyncEagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            profiles,
+            256,
+            [&](const pv::eagle::Expected<void> &status) {
+                is_callback_success = status.has_value();
+                num_callbacks++;
+            });
+    CHECK(created.has_value());
+    pv::eagle::AsyncEagle &eagle = **created;
+    CHECK(eagle.num_speakers() == 1);
+    CHECK(!eagle.is_ready());
+    CHECK(eagle.get() == nullptr);
+
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    float score = 0.f;
+    for (int32_t i = 0; i < 5; i++) {
+        const pv::eagle::Expected<bool> result = eagle.process(pcm, pv::eagle::Span<float>(&score, 1));
+        CHECK(result.has_value() && !result.value());
+    }
+    CHECK(score == 0.f);
+
+    const std::vector<int16_t> short_frame(PV_EAGLE_STUB_FRAME_LENGTH - 1, 0);
+    CHECK(eagle.process(short_frame, pv::eagle::Span<float>(&score, 1)).error().status() ==
+          PV_STATUS_INVALID_ARGUMENT);
+
+    CHECK(eagle.wait().has_value());
+    CHECK(eagle.is_ready());
+    CHECK(eagle.get() != nullptr);
+    CHECK(pv_eagle_stub_num_processed() == 5);
+    CHECK(eagle.num_dropped_frames() == 0);
+
+    pollfd fd = {eagle.ready_fd(), POLLIN, 0};
+    CHECK((poll(&fd, 1, 0) == 1) && ((fd.revents & POLLIN) != 0));
+
+    const pv::eagle::Expected<bool> result = eagle.process(pcm, pv::eagle::Span<float>(&score, 1));
+    CHECK(result.has_value() && result.value());
+    CHECK(score == 0.75f);
+    CHECK(pv_eagle_stub_num_processed() == 6);
+
+    created = pv::eagle::Error(PV_STATUS_INVALID_STATE);
+    CHECK((num_callbacks == 1) && is_callback_success);
+}
+
+static void test_drains_on_destruction() {
+    pv_eagle_stub_reset();
+    pv_eagle_stub_set_init_delay_ms(INIT_DELAY_MS);
+
+    const std::vector<pv::eagle::Profile> profiles = make_profiles();
+    {
+        pv::eagle::Expected<std::unique_ptr<pv::eagle::AsyncEagle>> eagle = pv::eagle::AsyncEagle::create(
+                ACCESS_KEY,
+                MODEL_PATH,
+                profiles);
+        CHECK(eagle.has_value());
+
+        const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+        float score = 0.f;
+        for (int32_t i = 0; i < 8; i++) {
+            CHECK(!(*eagle)->process(pcm, pv::eagle::Span<float>(&score, 1)).value());
+        }
+        CHECK(!(*eagle)->is_ready());
+    }
+
+    // the destructor waits for loading, which runs every frame queued before it
+    CHECK(pv_eagle_stub_num_processed() == 8);
+    CHECK(pv_eagle_stub_num_objects() == 0);
+}
+
+static void test_drops_oldest_frames() {
+    pv_eagle_stub_reset();
+    pv_eagle_stub_set_init_delay_ms(INIT_DELAY_MS);
+
+    const std::vector<pv::eagle::Profile> profiles = make_profiles();
+    pv::eagle::Expected<std::unique_ptr<pv::eagle::AsyncEagle>> eagle = pv::eagle::AsyncEagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            profiles,
+            3);
+    CHECK(eagle.has_value());
+
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    float score = 0.f;
+    for (int32_t i = 0; i < 5; i++) {
+        (void) (*eagle)->process(pcm, pv::eagle::Span<float>(&score, 1));
+    }
+
+    CHECK((*eagle)->wait().has_value());
+    CHECK((*eagle)->num_dropped_frames() == 2);
+    CHECK(pv_eagle_stub_num_processed() == 3);
+}
+
+static void test_init_failure() {
+    pv_eagle_stub_reset();
+    pv_eagle_stub_set_init_delay_ms(INIT_DELAY_MS);
+    pv_eagle_stub_set_init_status(PV_STATUS_ACTIVATION_LIMIT_REACHED);
+
+    pv_status_t callback_status = PV_STATUS_SUCCESS;
+    const std::vector<pv::eagle::Profile> profiles = make_profiles();
+    pv::eagle::Expected<std::unique_ptr<pv::eagle::AsyncEagle>> eagle = pv::eagle::AsyncEagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            profiles,
+            256,
+            [&](const pv::eagle::Expected<void> &status) { callback_status = status.error().status(); });
+    CHECK(eagle.has_value());
+
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    float score = 0.f;
+    CHECK(!(*eagle)->process(pcm, pv::eagle::Span<float>(&score, 1)).value());
+
+    CHECK((*eagle)->wait().error().status() == PV_STATUS_ACTIVATION_LIMIT_REACHED);
+    CHECK((*eagle)->get() == nullptr);
+    CHECK(pv_eagle_stub_num_processed() == 0);
+    CHECK((*eagle)->process(pcm, pv::eagle::Span<float>(&score, 1)).error().status() ==
+          PV_STATUS_ACTIVATION_LIMIT_REACHED);
+
+    eagle = pv::eagle::Error(PV_STATUS_INVALID_STATE);
+    CHECK(callback_status == PV_STATUS_ACTIVATION_LIMIT_REACHED);
+}
+
+static void test_no_buffer() {
+    pv_eagle_stub_reset();
+
+    bool is_callback_invoked = false;
+    const std::vector<pv::eagle::Profile> profiles = make_profiles();
+    const pv::eagle::Expected<std::unique_ptr<pv::eagle::AsyncEagle>> eagle = pv::eagle::AsyncEagle::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            profiles,
+            0,
+            [&](const pv::eagle::Expected<void> &) { is_callback_invoked = true; });
+    CHECK(eagle.error().status() == PV_STATUS_INVALID_ARGUMENT);
+    CHECK(!is_callback_invoked);
+    CHECK(pv_eagle_stub_num_objects() == 0);
+}
+
+int main() {
+    RUN_TEST(test_buffers_until_ready);
+    RUN_TEST(test_drains_on_destruction);
+    RUN_TEST(test_drops_oldest_frames);
+    RUN_TEST(test_init_failure);
+    RUN_TEST(test_no_buffer);
+
+    CHECK(pv_eagle_stub_num_objects() == 0);
+
+    return (num_failed_checks == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,242 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include <cmath>
+#include <vector>
+
+#include "pv_eagle_verifier.hpp"
+
+#include "check.h"
+#include "pv_eagle_stub.h"
+
+// Tests `pv_eagle_verifier.hpp` against the scripted library in `pv_eagle_stub.c`, which replays a fixed sequence of
+// scores. With the default score model, the log-likelihood ratio of a score `s` is
+// ((s - 0.25)^2 - (s - 0.75)^2) / (2 * 0.2^2) = 12.5 * (s - 0.5). The default thresholds are log(0.95 / 0.01) ~ 4.554
+// for accepting and log(0.05 / 0.99) ~ -2.986 for rejecting.
+
+static const char *ACCESS_KEY = "access_key";
+static const char *MODEL_PATH = "eagle_params.pv";
+static const double TOLERANCE = 1e-5;
+
+static pv::eagle::Verifier create_verifier(const pv::eagle::VerifierConfig &config) {
+    const std::vector<uint8_t> bytes(PV_EAGLE_STUB_PROFILE_SIZE, 1);
+    const pv::eagle::Profile profile = pv::eagle::Profile::from_bytes(bytes);
+    pv::eagle::Expected<pv::eagle::Verifier> verifier = pv::eagle::Verifier::create(
+            ACCESS_KEY,
+            MODEL_PATH,
+            profile,
+            config);
+    CHECK(verifier.has_value());
+    return std::move(verifier).value();
+}
+
+static pv::eagle::Decision process_frame(pv::eagle::Verifier &verifier) {
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    const pv::eagle::Expected<pv::eagle::Decision> decision = verifier.process(pcm);
+    CHECK(decision.has_value());
+    return decision ? decision.value() : pv::eagle::Decision::CONTINUE;
+}
+
+// Runs a fresh test that decides on a single observation of `score`.
+static pv::eagle::Decision decide_on_score(float score) {
+    pv_eagle_stub_reset();
+    pv_eagle_stub_set_scores(&score, 1);
+
+    pv::eagle::VerifierConfig config;
+    config.frames_per_observation = 1;
+    pv::eagle::Verifier verifier = create_verifier(config);
+    return process_frame(verifier);
+}
+
+static void test_observation_log_likelihood_ratio() {
+    pv_eagle_stub_reset();
+    const float script[] = {0.75f, 0.5f, 0.25f, 0.25f};
+    pv_eagle_stub_set_scores(script, 4);
+
+    pv::eagle::VerifierConfig config;
+    config.frames_per_observation = 1;
+    pv::eagle::Verifier verifier = create_verifier(config);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), 0.0, TOLERANCE);
+
+    const double expected[] = {3.125, 3.125, 0.0, -3.125};
+    for (int32_t i = 0; i < 4; i++) {
+        const pv::eagle::Decision decision = process_frame(verifier);
+        CHECK_NEAR(verifier.log_likelihood_ratio(), expected[i], TOLERANCE);
+        CHECK(decision == ((i < 3) ? pv::eagle::Decision::CONTINUE : pv::eagle::Decision::REJECT));
+    }
+    CHECK(verifier.num_frames() == 4);
+}
+
+static void test_observation_uses_last_frame() {
+    pv_eagle_stub_reset();
+    const float script[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.5f};
+    pv_eagle_stub_set_scores(script, 5);
+
+    pv::eagle::VerifierConfig config;
+    config.frames_per_observation = 4;
+    pv::eagle::Verifier verifier = create_verifier(config);
+
+    for (int32_t i = 0; i < 3; i++) {
+        CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+        CHECK_NEAR(verifier.log_likelihood_ratio(), 0.0, TOLERANCE);
+    }
+    CHECK(process_frame(verifier) == pv::eagle::Decision::ACCEPT);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), 6.25, TOLERANCE);
+}
+
+static void test_thresholds() {
+    const pv::eagle::VerifierConfig config;
+    const double accept_threshold = std::log((1.0 - config.false_reject_rate) / config.false_accept_rate);
+    const double reject_threshold = std::log(config.false_reject_rate / (1.0 - config.false_accept_rate));
+    CHECK_NEAR(accept_threshold, 4.5539, 1e-4);
+    CHECK_NEAR(reject_threshold, -2.9857, 1e-4);
+
+    CHECK(decide_on_score(0.86f) == pv::eagle::Decision::CONTINUE);
+    CHECK(decide_on_score(0.87f) == pv::eagle::Decision::ACCEPT);
+    CHECK(decide_on_score(0.27f) == pv::eagle::Decision::CONTINUE);
+    CHECK(decide_on_score(0.26f) == pv::eagle::Decision::REJECT);
+}
+
+static void test_accept_is_final() {
+    pv_eagle_stub_reset();
+    const float script[] = {0.75f};
+    pv_eagle_stub_set_scores(script, 1);
+
+    pv::eagle::Verifier verifier = create_verifier(pv::eagle::VerifierConfig());
+    for (int32_t i = 1; i < 16; i++) {
+        CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+    }
+    CHECK(process_frame(verifier) == pv::eagle::Decision::ACCEPT);
+    CHECK(verifier.decision() == pv::eagle::Decision::ACCEPT);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), 6.25, TOLERANCE);
+
+    // once decided, frames are no longer sent to the engine
+    const float impostor_script[] = {0.0f};
+    pv_eagle_stub_set_scores(impostor_script, 1);
+    for (int32_t i = 0; i < 32; i++) {
+        CHECK(process_frame(verifier) == pv::eagle::Decision::ACCEPT);
+    }
+    CHECK(verifier.num_frames() == 16);
+    CHECK(pv_eagle_stub_num_processed() == 16);
+}
+
+static void test_reject_and_reset() {
+    pv_eagle_stub_reset();
+    const float script[] = {0.25f};
+    pv_eagle_stub_set_scores(script, 1);
+
+    pv::eagle::Verifier verifier = create_verifier(pv::eagle::VerifierConfig());
+    for (int32_t i = 1; i < 8; i++) {
+        CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+    }
+    CHECK(process_frame(verifier) == pv::eagle::Decision::REJECT);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), -3.125, TOLERANCE);
+
+    CHECK(verifier.reset().has_value());
+    CHECK(verifier.decision() == pv::eagle::Decision::CONTINUE);
+    CHECK(verifier.num_frames() == 0);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), 0.0, TOLERANCE);
+    CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+    CHECK(verifier.num_frames() == 1);
+}
+
+static void test_truncation() {
+    pv::eagle::VerifierConfig config;
+    config.max_frames = 12;
+
+    // a single observation of 1.25 is between the thresholds, so the test is truncated and decided by its sign
+    const float genuine_script[] = {0.6f};
+    const float impostor_script[] = {0.4f};
+    const float *scripts[] = {genuine_script, impostor_script};
+    const double expected_ratios[] = {1.25, -1.25};
+    const pv::eagle::Decision expected_decisions[] = {pv::eagle::Decision::ACCEPT, pv::eagle::Decision::REJECT};
+    for (int32_t i = 0; i < 2; i++) {
+        pv_eagle_stub_reset();
+        pv_eagle_stub_set_scores(scripts[i], 1);
+
+        pv::eagle::Verifier verifier = create_verifier(config);
+        for (int32_t j = 1; j < config.max_frames; j++) {
+            CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+        }
+        CHECK(process_frame(verifier) == expected_decisions[i]);
+        CHECK_NEAR(verifier.log_likelihood_ratio(), expected_ratios[i], TOLERANCE);
+        CHECK(verifier.num_frames() == config.max_frames);
+    }
+
+    // a test truncated before its first observation has no evidence for the claimed speaker and rejects
+    pv_eagle_stub_reset();
+    const float accepting_script[] = {1.0f};
+    pv_eagle_stub_set_scores(accepting_script, 1);
+    config.max_frames = 4;
+    pv::eagle::Verifier verifier = create_verifier(config);
+    for (int32_t i = 1; i < 4; i++) {
+        CHECK(process_frame(verifier) == pv::eagle::Decision::CONTINUE);
+    }
+    CHECK(process_frame(verifier) == pv::eagle::Decision::REJECT);
+    CHECK_NEAR(verifier.log_likelihood_ratio(), 0.0, TOLERANCE);
+}
+
+static void test_process_error() {
+    pv_eagle_stub_reset();
+
+    pv::eagle::Verifier verifier = create_verifier(pv::eagle::VerifierConfig());
+    const std::vector<int16_t> pcm(PV_EAGLE_STUB_FRAME_LENGTH, 0);
+    pv_eagle_stub_set_process_status(PV_STATUS_RUNTIME_ERROR);
+    CHECK(verifier.process(pcm).error().status() == PV_STATUS_RUNTIME_ERROR);
+    CHECK(verifier.num_frames() == 0);
+    CHECK(verifier.decision() == pv::eagle::Decision::CONTINUE);
+}
+
+static void test_invalid_config() {
+    pv_eagle_stub_reset();
+
+    std::vector<pv::eagle::VerifierConfig> configs(7);
+    configs[0].false_accept_rate = 0.0;
+    configs[1].false_reject_rate = 0.0;
+    configs[2].false_accept_rate = 0.5;
+    configs[2].false_reject_rate = 0.5;
+    configs[3].impostor_mean = configs[3].genuine_mean;
+    configs[4].score_stddev = 0.0;
+    configs[5].frames_per_observation = 0;
+    configs[6].max_frames = -1;
+
+    const std::vector<uint8_t> bytes(PV_EAGLE_STUB_PROFILE_SIZE, 1);
+    const pv::eagle::Profile profile = pv::eagle::Profile::from_bytes(bytes);
+    for (const pv::eagle::VerifierConfig &config : configs) {
+        const pv::eagle::Expected<pv::eagle::Verifier> verifier = pv::eagle::Verifier::create(
+                ACCESS_KEY,
+                MODEL_PATH,
+                profile,
+                config);
+        CHECK(verifier.error().status() == PV_STATUS_INVALID_ARGUMENT);
+    }
+    CHECK(pv_eagle_stub_num_objects() == 0);
+
+    pv_eagle_stub_set_init_status(PV_STATUS_IO_ERROR);
+    CHECK(pv::eagle::Verifier::create(ACCESS_KEY, MODEL_PATH, profile).error().status() == PV_STATUS_IO_ERROR);
+}
+
+int main() {
+    RUN_TEST(test_observation_log_likelihood_ratio);
+    RUN_TEST(test_observation_uses_last_frame);
+    RUN_TEST(test_thresholds);
+    RUN_TEST(test_accept_is_final);
+    RUN_TEST(test_reject_and_reset);
+    RUN_TEST(test_truncation);
+    RUN_TEST(test_process_error);
+    RUN_TEST(test_invalid_config);
+
+    CHECK(pv_eagle_stub_num_objects() == 0);
+
+    return (num_failed_checks == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
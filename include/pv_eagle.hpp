@@ -0,0 +1,553 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_HPP
+#define PV_EAGLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+
+#include <span>
+
+#endif
+
+#include "pv_eagle.h"
+
+/**
+ * Header-only C++17 wrapper around the Eagle C API (`pv_eagle.h`).
+ *
+ * Objects own their underlying C handles and are move-only. Audio and score buffers are passed as non-owning spans, so
+ * `Eagle::process()` and `EagleProfiler::enroll()` forward the caller's memory straight to the C functions without any
+ * allocation or copying. Failures are reported through `Expected` values carrying the `pv_status_t` of the C call.
+ */
+namespace pv {
+    namespace eagle {
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+
+        template<typename T>
+        using Span = std::span<T>;
+
+#else
+
+        /**
+         * Minimal non-owning view over a contiguous sequence. It is an alias of `std::span` when compiled as C++20.
+         */
+        template<typename T>
+        class Span {
+        public:
+            constexpr Span() noexcept : data_(nullptr), size_(0) {}
+
+            constexpr Span(T *data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+            template<std::size_t N>
+            constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N) {}
+
+            template<
+                    typename Container,
+                    typename = std::enable_if_t<
+                            std::is_convertible<
+                                    std::remove_pointer_t<decltype(std::declval<Container &>().data())> (*)[],
+                                    T (*)[]>::value>>
+            constexpr Span(Container &container) noexcept : data_(container.data()), size_(container.size()) {}
+
+            constexpr T *data() const noexcept {
+                return data_;
+            }
+
+            constexpr std::size_t size() const noexcept {
+                return size_;
+            }
+
+            constexpr bool empty() const noexcept {
+                return size_ == 0;
+            }
+
+            constexpr T &operator[](std::size_t index) const noexcept {
+                return data_[index];
+            }
+
+            constexpr T *begin() const noexcept {
+                return data_;
+            }
+
+            constexpr T *end() const noexcept {
+                return data_ + size_;
+            }
+
+            constexpr Span subspan(std::size_t offset, std::size_t count) const noexcept {
+                return Span(data_ + offset, count);
+            }
+
+        private:
+            T *data_;
+            std::size_t size_;
+        };
+
+#endif
+
+        /**
+         * Error returned by a failed call. It carries the status code of the underlying C function.
+         */
+        class Error {
+        public:
+            explicit constexpr Error(pv_status_t status) noexcept : status_(status) {}
+
+            constexpr pv_status_t status() const noexcept {
+                return status_;
+            }
+
+            const char *message() const noexcept {
+                return pv_status_to_string(status_);
+            }
+
+        private:
+            pv_status_t status_;
+        };
+
+        /**
+         * Holds either a value or an `Error`, in the style of `std::expected`.
+         */
+        template<typename T>
+        class Expected {
+        public:
+            Expected(T value) : value_(std::in_place_index<0>, std::move(value)) {}
+
+            Expected(Error error) : value_(std::in_place_index<1>, error) {}
+
+            bool has_value() const noexcept {
+                return value_.index() == 0;
+            }
+
+            explicit operator bool() const noexcept {
+                return has_value();
+            }
+
+            /**
+             * The held value. Accessing it when an error is held throws `std::bad_variant_access`.
+             */
+            T &value() & {
+                return std::get<0>(value_);
+            }
+
+            const T &value() const & {
+                return std::get<0>(value_);
+            }
+
+            T &&value() && {
+                return std::get<0>(std::move(value_));
+            }
+
+            T &operator*() & {
+                return std::get<0>(value_);
+            }
+
+            T *operator->() {
+                return &std::get<0>(value_);
+            }
+
+            const T *operator->() const {
+                return &std::get<0>(value_);
+            }
+
+            /**
+             * The held error, or `PV_STATUS_SUCCESS` when a value is held.
+             */
+            Error error() const noexcept {
+                return has_value() ? Error(PV_STATUS_SUCCESS) : *std::get_if<1>(&value_);
+            }
+
+        private:
+            std::variant<T, Error> value_;
+        };
+
+        template<>
+        class Expected<void> {
+        public:
+            Expected() noexcept : error_(PV_STATUS_SUCCESS) {}
+
+            Expected(Error error) noexcept : error_(error) {}
+
+            bool has_value() const noexcept {
+                return error_.status() == PV_STATUS_SUCCESS;
+            }
+
+            explicit operator bool() const noexcept {
+                return has_value();
+            }
+
+            const Error &error() const noexcept {
+                return error_;
+            }
+
+        private:
+            Error error_;
+        };
+
+        namespace detail {
+
+            inline Expected<void> check(pv_status_t status) noexcept {
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return {};
+            }
+
+        } // namespace detail
+
+        /**
+         * Audio sample rate accepted by Eagle and EagleProfiler.
+         */
+        inline int32_t sample_rate() noexcept {
+            return pv_sample_rate();
+        }
+
+        /**
+         * Version of the Eagle library.
+         */
+        inline const char *version() noexcept {
+            return pv_eagle_version();
+        }
+
+        /**
+         * Serialized speaker profile. It owns its bytes and is move-only.
+         */
+        class Profile {
+        public:
+            Profile() noexcept = default;
+
+            Profile(Profile &&other) noexcept
+                : data_(std::move(other.data_)),
+                  size_(std::exchange(other.size_, 0)) {}
+
+            Profile &operator=(Profile &&other) noexcept {
+                if (this != &other) {
+                    data_ = std::move(other.data_);
+                    size_ = std::exchange(other.size_, 0);
+                }
+                return *this;
+            }
+
+            Profile(const Profile &) = delete;
+
+            Profile &operator=(const Profile &) = delete;
+
+            /**
+             * Creates a profile from serialized bytes, e.g. read back from storage. The bytes are copied.
+             *
+             * @param bytes Serialized profile as produced by `EagleProfiler::export_profile()`.
+             * @return Profile object.
+             */
+            static Profile from_bytes(Span<const uint8_t> bytes) {
+                Profile profile(bytes.size());
+                std::memcpy(profile.data_.get(), bytes.data(), bytes.size());
+                return profile;
+            }
+
+            /**
+             * Serialized profile bytes.
+             */
+            Span<const uint8_t> bytes() const noexcept {
+                return Span<const uint8_t>(data_.get(), size_);
+            }
+
+            const void *data() const noexcept {
+                return data_.get();
+            }
+
+            std::size_t size() const noexcept {
+                return size_;
+            }
+
+        private:
+            friend class EagleProfiler;
+
+            explicit Profile(std::size_t size) : data_(new uint8_t[size]), size_(size) {}
+
+            std::unique_ptr<uint8_t[]> data_;
+            std::size_t size_ = 0;
+        };
+
+        /**
+         * Result of a single `EagleProfiler::enroll()` call.
+         */
+        struct EnrollResult {
+            pv_eagle_profiler_enroll_feedback_t feedback;
+            float percentage;
+        };
+
+        /**
+         * Wrapper for `pv_eagle_profiler_t`. It enrolls a speaker given a set of utterances and then exports a profile for
+         * the enrolled speaker.
+         */
+        class EagleProfiler {
+        public:
+            EagleProfiler(EagleProfiler &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+            EagleProfiler &operator=(EagleProfiler &&other) noexcept {
+                if (this != &other) {
+                    if (handle_) {
+                        pv_eagle_profiler_delete(handle_);
+                    }
+                    handle_ = std::exchange(other.handle_, nullptr);
+                }
+                return *this;
+            }
+
+            EagleProfiler(const EagleProfiler &) = delete;
+
+            EagleProfiler &operator=(const EagleProfiler &) = delete;
+
+            ~EagleProfiler() {
+                if (handle_) {
+                    pv_eagle_profiler_delete(handle_);
+                }
+            }
+
+            /**
+             * Constructor.
+             *
+             * @param access_key AccessKey obtained from Picovoice Console (https://console.picovoice.ai/).
+             * @param model_path Absolute path to the file containing model parameters.
+             * @return EagleProfiler object, or the status returned by `pv_eagle_profiler_init()`.
+             */
+            static Expected<EagleProfiler> create(const char *access_key, const char *model_path) {
+                pv_eagle_profiler_t *handle = nullptr;
+                const pv_status_t status = pv_eagle_profiler_init(access_key, model_path, &handle);
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return EagleProfiler(handle);
+            }
+
+            /**
+             * Enrolls a speaker. See `pv_eagle_profiler_enroll()`.
+             *
+             * @param pcm Audio data. It is passed to the engine without copying.
+             * @return Enrollment feedback and percentage, or the status returned by the engine.
+             */
+            Expected<EnrollResult> enroll(Span<const int16_t> pcm) noexcept {
+                EnrollResult result = {PV_EAGLE_PROFILER_ENROLL_FEEDBACK_AUDIO_OK, 0.f};
+                const pv_status_t status = pv_eagle_profiler_enroll(
+                        handle_,
+                        pcm.data(),
+                        static_cast<int32_t>(pcm.size()),
+                        &result.feedback,
+                        &result.percentage);
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return result;
+            }
+
+            /**
+             * Minimum number of samples required by `enroll()`.
+             */
+            Expected<int32_t> min_enroll_samples() const noexcept {
+                int32_t num_samples = 0;
+                const pv_status_t status = pv_eagle_profiler_enroll_min_audio_length_samples(handle_, &num_samples);
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return num_samples;
+            }
+
+            /**
+             * Size of the exported speaker profile in bytes.
+             */
+            Expected<int32_t> export_size() const noexcept {
+                int32_t size_bytes = 0;
+                const pv_status_t status = pv_eagle_profiler_export_size(handle_, &size_bytes);
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return size_bytes;
+            }
+
+            /**
+             * Exports the speaker profile into a caller-provided buffer of at least `export_size()` bytes.
+             *
+             * @param profile Output buffer.
+             * @return `PV_STATUS_INVALID_ARGUMENT` if the buffer is too small, otherwise the status of the export.
+             */
+            Expected<void> export_to(Span<uint8_t> profile) const noexcept {
+                const Expected<int32_t> size_bytes = export_size();
+                if (!size_bytes) {
+                    return size_bytes.error();
+                }
+                if (profile.size() < static_cast<std::size_t>(size_bytes.value())) {
+                    return Error(PV_STATUS_INVALID_ARGUMENT);
+                }
+                return detail::check(pv_eagle_profiler_export(handle_, profile.data()));
+            }
+
+            /**
+             * Exports the speaker profile into a newly allocated `Profile`.
+             */
+            Expected<Profile> export_profile() const {
+                const Expected<int32_t> size_bytes = export_size();
+                if (!size_bytes) {
+                    return size_bytes.error();
+                }
+                Profile profile(static_cast<std::size_t>(size_bytes.value()));
+                const pv_status_t status = pv_eagle_profiler_export(handle_, profile.data_.get());
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return profile;
+            }
+
+            /**
+             * Removes all enrollment data. It must be called before enrolling a new speaker.
+             */
+            Expected<void> reset() noexcept {
+                return detail::check(pv_eagle_profiler_reset(handle_));
+            }
+
+            /**
+             * Underlying C handle. Ownership stays with this object.
+             */
+            pv_eagle_profiler_t *get() const noexcept {
+                return handle_;
+            }
+
+        private:
+            explicit EagleProfiler(pv_eagle_profiler_t *handle) noexcept : handle_(handle) {}
+
+            pv_eagle_profiler_t *handle_ = nullptr;
+        };
+
+        /**
+         * Wrapper for `pv_eagle_t`. It processes consecutive frames of audio and emits a similarity score for each
+         * enrolled speaker.
+         */
+        class Eagle {
+        public:
+            Eagle(Eagle &&other) noexcept
+                : handle_(std::exchange(other.handle_, nullptr)),
+                  num_speakers_(other.num_speakers_) {}
+
+            Eagle &operator=(Eagle &&other) noexcept {
+                if (this != &other) {
+                    if (handle_) {
+                        pv_eagle_delete(handle_);
+                    }
+                    handle_ = std::exchange(other.handle_, nullptr);
+                    num_speakers_ = other.num_speakers_;
+                }
+                return *this;
+            }
+
+            Eagle(const Eagle &) = delete;
+
+            Eagle &operator=(const Eagle &) = delete;
+
+            ~Eagle() {
+                if (handle_) {
+                    pv_eagle_delete(handle_);
+                }
+            }
+
+            /**
+             * Constructor. The array of profile pointers handed to `pv_eagle_init()` is the only allocation made by the
+             * wrapper and it is released before returning.
+             *
+             * @param access_key AccessKey obtained from Picovoice Console (https://console.picovoice.ai/).
+             * @param model_path Absolute path to the file containing model parameters.
+             * @param speaker_profiles Speaker profiles, in the order their scores are reported by `process()`.
+             * @return Eagle object, or the status returned by `pv_eagle_init()`.
+             */
+            static Expected<Eagle> create(
+                    const char *access_key,
+                    const char *model_path,
+                    Span<const Profile> speaker_profiles) {
+                std::vector<const void *> profile_data;
+                profile_data.reserve(speaker_profiles.size());
+                for (const Profile &profile : speaker_profiles) {
+                    profile_data.push_back(profile.data());
+                }
+
+                pv_eagle_t *handle = nullptr;
+                const pv_status_t status = pv_eagle_init(
+                        access_key,
+                        model_path,
+                        static_cast<int32_t>(profile_data.size()),
+                        profile_data.data(),
+                        &handle);
+                if (status != PV_STATUS_SUCCESS) {
+                    return Error(status);
+                }
+                return Eagle(handle, static_cast<int32_t>(profile_data.size()));
+            }
+
+            /**
+             * Processes a frame of audio. Both buffers are passed to the engine without copying.
+             *
+             * @param pcm A frame of `frame_length()` samples.
+             * @param[out] scores Output buffer with room for at least `num_speakers()` scores.
+             * @return `PV_STATUS_INVALID_ARGUMENT` if either buffer has the wrong size, otherwise the status of
+             * `pv_eagle_process()`.
+             */
+            Expected<void> process(Span<const int16_t> pcm, Span<float> scores) noexcept {
+                if ((pcm.size() != static_cast<std::size_t>(frame_length())) ||
+                    (scores.size() < static_cast<std::size_t>(num_speakers_))) {
+                    return Error(PV_STATUS_INVALID_ARGUMENT);
+                }
+                return detail::check(pv_eagle_process(handle_, pcm.data(), scores.data()));
+            }
+
+            /**
+             * Resets the internal state. It must be called before processing a new sequence of audio frames.
+             */
+            Expected<void> reset() noexcept {
+                return detail::check(pv_eagle_reset(handle_));
+            }
+
+            /**
+             * Number of enrolled speakers, i.e. the number of scores written by `process()`.
+             */
+            int32_t num_speakers() const noexcept {
+                return num_speakers_;
+            }
+
+            /**
+             * Number of audio samples per frame.
+             */
+            static int32_t frame_length() noexcept {
+                return pv_eagle_frame_length();
+            }
+
+            /**
+             * Underlying C handle. Ownership stays with this object.
+             */
+            pv_eagle_t *get() const noexcept {
+                return handle_;
+            }
+
+        private:
+            Eagle(pv_eagle_t *handle, int32_t num_speakers) noexcept : handle_(handle), num_speakers_(num_speakers) {}
+
+            pv_eagle_t *handle_ = nullptr;
+            int32_t num_speakers_ = 0;
+        };
+
+    } // namespace eagle
+} // namespace pv
+
+#endif // PV_EAGLE_HPP
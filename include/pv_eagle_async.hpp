@@ -0,0 +1,289 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_ASYNC_HPP
+#define PV_EAGLE_ASYNC_HPP
+
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif
+
+#include "pv_eagle.hpp"
+
+/**
+ * Non-blocking construction of `Eagle` on top of `pv_eagle.hpp`.
+ *
+ * `pv_eagle_init()` reads and prepares the model before it returns, which can take a noticeable amount of time on mobile
+ * and embedded devices. `AsyncEagle::create()` returns immediately and runs `pv_eagle_init()` on a background thread, so
+ * an application can start capturing audio straight away. Frames passed to `process()` before the engine is ready are
+ * copied into a bounded queue and run through the engine, in order, as soon as loading finishes. Completion is signalled
+ * through an optional callback, `wait()`, `is_ready()` and, on POSIX systems, a file descriptor that becomes readable
+ * and can be added to an existing `poll()`/`epoll` loop.
+ */
+namespace pv {
+    namespace eagle {
+
+        /**
+         * `Eagle` instance that is loaded on a background thread. Objects are neither copyable nor movable since the
+         * loading thread refers to them; `create()` returns them behind a `std::unique_ptr`. The destructor waits for
+         * loading to finish.
+         */
+        class AsyncEagle {
+        public:
+            /**
+             * Invoked once on the loading thread, after any buffered frames have been processed, with the status of
+             * `pv_eagle_init()` or of the first failing `pv_eagle_process()` call.
+             */
+            using ReadyCallback = std::function<void(const Expected<void> &)>;
+
+            AsyncEagle(const AsyncEagle &) = delete;
+
+            AsyncEagle &operator=(const AsyncEagle &) = delete;
+
+            ~AsyncEagle() {
+                if (loader_.joinable()) {
+                    loader_.join();
+                }
+#if defined(__unix__) || defined(__APPLE__)
+                close(ready_fds_[0]);
+                close(ready_fds_[1]);
+#endif
+            }
+
+            /**
+             * Starts loading Eagle on a background thread and returns without waiting for it. The arguments are copied,
+             * so they do not need to outlive the call.
+             *
+             * @param access_key AccessKey obtained from Picovoice Console (https://console.picovoice.ai/).
+             * @param model_path Absolute path to the file containing model parameters.
+             * @param speaker_profiles Speaker profiles, in the order their scores are reported by `process()`.
+             * @param max_buffered_frames Maximum number of frames kept while loading, at least one. Once the queue is
+             * full the oldest frame is dropped for every new one.
+             * @param on_ready Optional callback invoked on the loading thread when the engine is ready or has failed.
+             * @return AsyncEagle object, `PV_STATUS_INVALID_ARGUMENT` if `max_buffered_frames` is 0, or
+             * `PV_STATUS_RUNTIME_ERROR` if the readiness descriptor cannot be created.
+             */
+            static Expected<std::unique_ptr<AsyncEagle>> create(
+                    const char *access_key,
+                    const char *model_path,
+                    Span<const Profile> speaker_profiles,
+                    std::size_t max_buffered_frames = 256,
+                    ReadyCallback on_ready = nullptr) {
+                if (max_buffered_frames == 0) {
+                    return Error(PV_STATUS_INVALID_ARGUMENT);
+                }
+
+                std::unique_ptr<AsyncEagle> eagle(new AsyncEagle(
+                        access_key,
+                        model_path,
+                        speaker_profiles,
+                        max_buffered_frames,
+                        std::move(on_ready)));
+
+#if defined(__unix__) || defined(__APPLE__)
+                if (pipe(eagle->ready_fds_) != 0) {
+                    return Error(PV_STATUS_RUNTIME_ERROR);
+                }
+                fcntl(eagle->ready_fds_[0], F_SETFD, FD_CLOEXEC);
+                fcntl(eagle->ready_fds_[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+                AsyncEagle *self = eagle.get();
+                eagle->loader_ = std::thread([self] { self->load(); });
+                return eagle;
+            }
+
+            /**
+             * Processes a frame of audio. Until the engine is ready the frame is copied into the queue, the scores are
+             * left untouched and the result is `false`. Afterwards it forwards to `Eagle::process()` without copying
+             * and the result is `true`.
+             *
+             * @param pcm A frame of `Eagle::frame_length()` samples.
+             * @param[out] scores Output buffer with room for at least `num_speakers()` scores.
+             * @return Whether scores were written, `PV_STATUS_INVALID_ARGUMENT` if either buffer has the wrong size, or
+             * the status of loading or processing if it failed.
+             */
+            Expected<bool> process(Span<const int16_t> pcm, Span<float> scores) {
+                if ((pcm.size() != static_cast<std::size_t>(Eagle::frame_length())) ||
+                    (scores.size() < static_cast<std::size_t>(num_speakers_))) {
+                    return Error(PV_STATUS_INVALID_ARGUMENT);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!is_ready_) {
+                        if (pending_.size() == max_buffered_frames_) {
+                            pending_.pop_front();
+                            num_dropped_frames_++;
+                        }
+                        pending_.emplace_back(pcm.begin(), pcm.end());
+                        return false;
+                    }
+                }
+
+                if (!status_) {
+                    return status_.error();
+                }
+                const Expected<void> status = eagle_->process(pcm, scores);
+                if (!status) {
+                    return status.error();
+                }
+                return true;
+            }
+
+            /**
+             * Whether loading has finished, successfully or not, and the buffered frames have been processed.
+             */
+            bool is_ready() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return is_ready_;
+            }
+
+            /**
+             * Blocks until the engine is ready.
+             *
+             * @return The status of loading and of processing the buffered frames.
+             */
+            Expected<void> wait() const {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return is_ready_; });
+                return status_;
+            }
+
+#if defined(__unix__) || defined(__APPLE__)
+
+            /**
+             * File descriptor that becomes readable once the engine is ready. It stays readable and is owned by this
+             * object.
+             */
+            int ready_fd() const noexcept {
+                return ready_fds_[0];
+            }
+
+#endif
+
+            /**
+             * Number of frames dropped because the queue was full while loading.
+             */
+            std::size_t num_dropped_frames() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return num_dropped_frames_;
+            }
+
+            /**
+             * Number of enrolled speakers, i.e. the number of scores written by `process()`. It is known before loading
+             * finishes.
+             */
+            int32_t num_speakers() const noexcept {
+                return num_speakers_;
+            }
+
+            /**
+             * The loaded engine, or `nullptr` while loading or if loading failed. Once ready it may be used directly,
+             * e.g. to `reset()` it, from the thread that calls `process()`.
+             */
+            Eagle *get() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return (is_ready_ && eagle_) ? &*eagle_ : nullptr;
+            }
+
+        private:
+            AsyncEagle(
+                    const char *access_key,
+                    const char *model_path,
+                    Span<const Profile> speaker_profiles,
+                    std::size_t max_buffered_frames,
+                    ReadyCallback on_ready)
+                : access_key_(access_key),
+                  model_path_(model_path),
+                  num_speakers_(static_cast<int32_t>(speaker_profiles.size())),
+                  max_buffered_frames_(max_buffered_frames),
+                  on_ready_(std::move(on_ready)),
+                  eagle_(Error(PV_STATUS_INVALID_STATE)) {
+                profiles_.reserve(speaker_profiles.size());
+                for (const Profile &profile : speaker_profiles) {
+                    profiles_.push_back(Profile::from_bytes(profile.bytes()));
+                }
+            }
+
+            void load() {
+                Expected<Eagle> eagle = Eagle::create(access_key_.c_str(), model_path_.c_str(), profiles_);
+                Expected<void> status = eagle ? Expected<void>() : Expected<void>(eagle.error());
+
+                // frames keep arriving while the backlog is processed, so the queue is only declared drained under the
+                // lock that `process()` takes before appending to it
+                std::vector<float> scores(static_cast<std::size_t>(num_speakers_));
+                std::vector<int16_t> pcm;
+                for (;;) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (pending_.empty() || !status) {
+                            pending_.clear();
+                            eagle_ = std::move(eagle);
+                            status_ = status;
+                            is_ready_ = true;
+                            break;
+                        }
+                        pcm = std::move(pending_.front());
+                        pending_.pop_front();
+                    }
+                    status = eagle->process(pcm, scores);
+                }
+                ready_.notify_all();
+
+#if defined(__unix__) || defined(__APPLE__)
+                const char byte = 1;
+                while ((write(ready_fds_[1], &byte, 1) < 0) && (errno == EINTR)) {
+                }
+#endif
+
+                if (on_ready_) {
+                    on_ready_(status_);
+                }
+            }
+
+            const std::string access_key_;
+            const std::string model_path_;
+            std::vector<Profile> profiles_;
+            const int32_t num_speakers_;
+            const std::size_t max_buffered_frames_;
+            ReadyCallback on_ready_;
+
+            mutable std::mutex mutex_;
+            mutable std::condition_variable ready_;
+            std::deque<std::vector<int16_t>> pending_;
+            std::size_t num_dropped_frames_ = 0;
+            bool is_ready_ = false;
+            Expected<Eagle> eagle_;
+            Expected<void> status_;
+
+#if defined(__unix__) || defined(__APPLE__)
+            int ready_fds_[2] = {-1, -1};
+#endif
+
+            std::thread loader_;
+        };
+
+    } // namespace eagle
+} // namespace pv
+
+#endif // PV_EAGLE_ASYNC_HPP
@@ -0,0 +1,620 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_PIPELINE_HPP
+#define PV_EAGLE_PIPELINE_HPP
+
+#if __cplusplus < 202002L
+#error "pv_eagle_pipeline.hpp requires C++20"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "pv_eagle.hpp"
+#include "pv_eagle_resources.hpp"
+
+/**
+ * C++20 coroutine building blocks for audio-to-score pipelines on top of `pv_eagle.hpp`.
+ *
+ * A pipeline is a chain of lazy generators: a source yields chunks of PCM, `frames()` cuts them into frames of
+ * `Eagle::frame_length()` samples, and `score()` runs `Eagle::process()` on each frame. Every stage yields views into a
+ * buffer it owns and reuses, so no audio or scores are copied between stages except for the samples of a frame that
+ * straddles two source chunks. `ThreadPool` is a work-stealing executor that runs many such pipelines, one per stream,
+ * on a fixed set of threads.
+ *
+ * Sources that can run dry, such as FIFOs and sockets, are read in non-blocking mode. When no data is available the
+ * source yields an empty chunk, every later stage passes it on as an empty item, and `run_pipeline()` suspends the task
+ * until the descriptor is readable instead of parking a pool thread in `read()`.
+ */
+namespace pv {
+    namespace eagle {
+
+        /**
+         * Lazily evaluated sequence of values produced by a coroutine with `co_yield`. Yielded values are only valid
+         * until the generator is advanced.
+         */
+        template<typename T>
+        class Generator {
+        public:
+            struct promise_type {
+                const T *value = nullptr;
+                std::exception_ptr exception;
+
+                Generator get_return_object() noexcept {
+                    return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_always initial_suspend() noexcept {
+                    return {};
+                }
+
+                std::suspend_always final_suspend() noexcept {
+                    return {};
+                }
+
+                std::suspend_always yield_value(const T &yielded) noexcept {
+                    value = std::addressof(yielded);
+                    return {};
+                }
+
+                void return_void() noexcept {}
+
+                void unhandled_exception() noexcept {
+                    exception = std::current_exception();
+                }
+
+                template<typename U>
+                std::suspend_never await_transform(U &&) = delete;
+            };
+
+            class Iterator {
+            public:
+                explicit Iterator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+                const T &operator*() const noexcept {
+                    return *handle_.promise().value;
+                }
+
+                Iterator &operator++() {
+                    resume(handle_);
+                    return *this;
+                }
+
+                bool operator==(std::default_sentinel_t) const noexcept {
+                    return !handle_ || handle_.done();
+                }
+
+            private:
+                std::coroutine_handle<promise_type> handle_;
+            };
+
+            Generator(Generator &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+            Generator &operator=(Generator &&other) noexcept {
+                if (this != &other) {
+                    if (handle_) {
+                        handle_.destroy();
+                    }
+                    handle_ = std::exchange(other.handle_, nullptr);
+                }
+                return *this;
+            }
+
+            Generator(const Generator &) = delete;
+
+            Generator &operator=(const Generator &) = delete;
+
+            ~Generator() {
+                if (handle_) {
+                    handle_.destroy();
+                }
+            }
+
+            Iterator begin() {
+                resume(handle_);
+                return Iterator(handle_);
+            }
+
+            std::default_sentinel_t end() const noexcept {
+                return {};
+            }
+
+        private:
+            explicit Generator(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+            static void resume(std::coroutine_handle<promise_type> handle) {
+                handle.resume();
+                if (handle.done() && handle.promise().exception) {
+                    std::rethrow_exception(handle.promise().exception);
+                }
+            }
+
+            std::coroutine_handle<promise_type> handle_;
+        };
+
+        /**
+         * Source that reads raw 16-bit little-endian PCM from a file descriptor, e.g. a file, a FIFO, stdin or a
+         * connected socket. It yields chunks of up to `chunk_samples` samples out of a single reused buffer and ends
+         * at end of stream or on a read error.
+         *
+         * A descriptor in blocking mode blocks the calling thread until data arrives, which only suits regular files.
+         * Other descriptors should be put in non-blocking mode with `set_nonblocking()`; the source then yields an
+         * empty chunk whenever no data is available, so that `run_pipeline()` can wait for the descriptor to become
+         * readable without holding a thread.
+         *
+         * @param fd Open file descriptor. It is not closed by the source.
+         * @param chunk_samples Number of samples requested per `read()`.
+         */
+        inline Generator<Span<const int16_t>> read_pcm(int fd, std::size_t chunk_samples) {
+            std::unique_ptr<int16_t[]> buffer(new int16_t[chunk_samples]);
+            uint8_t *bytes = reinterpret_cast<uint8_t *>(buffer.get());
+            const std::size_t capacity_bytes = chunk_samples * sizeof(int16_t);
+
+            std::size_t num_bytes = 0;
+            while (true) {
+                const ssize_t num_read = read(fd, bytes + num_bytes, capacity_bytes - num_bytes);
+                if (num_read < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                        co_yield Span<const int16_t>();
+                        continue;
+                    }
+                    break;
+                }
+                if (num_read == 0) {
+                    break;
+                }
+
+                num_bytes += static_cast<std::size_t>(num_read);
+                const std::size_t num_samples = num_bytes / sizeof(int16_t);
+                if (num_samples > 0) {
+                    co_yield Span<const int16_t>(buffer.get(), num_samples);
+
+                    // an odd trailing byte belongs to the next sample
+                    const std::size_t remainder = num_bytes % sizeof(int16_t);
+                    if (remainder > 0) {
+                        bytes[0] = bytes[num_samples * sizeof(int16_t)];
+                    }
+                    num_bytes = remainder;
+                }
+            }
+        }
+
+        /**
+         * Puts `fd` in non-blocking mode for use with `read_pcm()` and `run_pipeline()`.
+         *
+         * @return Whether the mode was changed.
+         */
+        inline bool set_nonblocking(int fd) noexcept {
+            const int flags = fcntl(fd, F_GETFL);
+            return (flags >= 0) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+        }
+
+        /**
+         * Framing stage. It cuts arbitrarily sized chunks into frames of exactly `frame_length` samples. Frames that lie
+         * entirely within a chunk are yielded as views into that chunk; only frames that straddle a chunk boundary are
+         * assembled in an internal buffer. A trailing partial frame is dropped. An empty chunk, signalling that the
+         * source has no data yet, is passed on as an empty frame.
+         *
+         * @param chunks Upstream stage.
+         * @param frame_length Number of samples per frame, normally `Eagle::frame_length()`.
+         */
+        inline Generator<Span<const int16_t>> frames(Generator<Span<const int16_t>> chunks, std::size_t frame_length) {
+            std::unique_ptr<int16_t[]> carry(new int16_t[frame_length]);
+            std::size_t num_carried = 0;
+
+            for (Span<const int16_t> chunk : chunks) {
+                if (chunk.empty()) {
+                    co_yield chunk;
+                    continue;
+                }
+
+                std::size_t offset = 0;
+
+                if (num_carried > 0) {
+                    const std::size_t num_copied = std::min(frame_length - num_carried, chunk.size());
+                    std::memcpy(carry.get() + num_carried, chunk.data(), num_copied * sizeof(int16_t));
+                    num_carried += num_copied;
+                    offset = num_copied;
+
+                    if (num_carried < frame_length) {
+                        continue;
+                    }
+                    co_yield Span<const int16_t>(carry.get(), frame_length);
+                    num_carried = 0;
+                }
+
+                while ((chunk.size() - offset) >= frame_length) {
+                    co_yield chunk.subspan(offset, frame_length);
+                    offset += frame_length;
+                }
+
+                num_carried = chunk.size() - offset;
+                std::memcpy(carry.get(), chunk.data() + offset, num_carried * sizeof(int16_t));
+            }
+        }
+
+        /**
+         * Inference stage. It runs `Eagle::process()` on every frame and yields the scores, one per enrolled speaker,
+         * out of a single reused buffer. An empty frame is passed on as empty scores. On failure the stage ends and
+         * `status` holds the error.
+         *
+         * @param eagle Eagle object. It must not be used by any other stage while the pipeline runs.
+         * @param frames Upstream framing stage.
+         * @param[out] status Status of the last `Eagle::process()` call.
+         */
+        inline Generator<Span<const float>> score(
+                Eagle &eagle,
+                Generator<Span<const int16_t>> frames,
+                Expected<void> &status) {
+            std::unique_ptr<float[]> scores(new float[eagle.num_speakers()]);
+            const Span<float> scores_view(scores.get(), static_cast<std::size_t>(eagle.num_speakers()));
+
+            for (Span<const int16_t> frame : frames) {
+                if (frame.empty()) {
+                    co_yield Span<const float>();
+                    continue;
+                }
+
+                status = eagle.process(frame, scores_view);
+                if (!status) {
+                    break;
+                }
+                co_yield Span<const float>(scores_view.data(), scores_view.size());
+            }
+        }
+
+        /**
+         * Coroutine type for detached pipeline tasks. It starts running immediately and frees itself on completion.
+         */
+        struct Task {
+            struct promise_type {
+                Task get_return_object() noexcept {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() noexcept {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() noexcept {
+                    return {};
+                }
+
+                void return_void() noexcept {}
+
+                void unhandled_exception() noexcept {
+                    std::terminate();
+                }
+            };
+        };
+
+        /**
+         * Work-stealing executor. Each worker owns a queue of suspended coroutines. A coroutine scheduled from a worker
+         * goes to the back of that worker's queue, and idle workers steal from the back of other workers' queues. An
+         * additional thread `poll()`s the descriptors that suspended coroutines wait on and schedules each coroutine
+         * once its descriptor is readable. The pool must outlive the coroutines it runs.
+         */
+        class ThreadPool {
+        public:
+            class ScheduleAwaiter {
+            public:
+                explicit ScheduleAwaiter(ThreadPool &pool) noexcept : pool_(pool) {}
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) {
+                    pool_.enqueue(handle);
+                }
+
+                void await_resume() const noexcept {}
+
+            private:
+                ThreadPool &pool_;
+            };
+
+            class ReadableAwaiter {
+            public:
+                ReadableAwaiter(ThreadPool &pool, int fd) noexcept : pool_(pool), fd_(fd) {}
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) {
+                    pool_.enqueue_when_readable(fd_, handle);
+                }
+
+                void await_resume() const noexcept {}
+
+            private:
+                ThreadPool &pool_;
+                int fd_;
+            };
+
+            explicit ThreadPool(std::size_t num_threads) {
+                num_threads = std::max<std::size_t>(num_threads, 1);
+                for (std::size_t i = 0; i < num_threads; i++) {
+                    queues_.push_back(std::make_unique<Queue>());
+                }
+                for (std::size_t i = 0; i < num_threads; i++) {
+                    threads_.emplace_back([this, i] { run(i); });
+                }
+
+                if (pipe(wake_fds_) == 0) {
+                    fcntl(wake_fds_[0], F_SETFL, fcntl(wake_fds_[0], F_GETFL) | O_NONBLOCK);
+                    poller_ = std::thread([this] { poll_readable(); });
+                }
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            ~ThreadPool() {
+                if (poller_.joinable()) {
+                    {
+                        std::lock_guard<std::mutex> lock(readable_mutex_);
+                        stop_polling_ = true;
+                    }
+                    wake_poller();
+                    poller_.join();
+                    close(wake_fds_[0]);
+                    close(wake_fds_[1]);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stop_ = true;
+                }
+                cv_.notify_all();
+                for (std::thread &thread : threads_) {
+                    thread.join();
+                }
+            }
+
+            /**
+             * Awaitable that suspends the calling coroutine and resumes it on one of the pool's threads. Awaiting it
+             * periodically from a long-running pipeline lets other pipelines share the same threads.
+             */
+            ScheduleAwaiter schedule() noexcept {
+                return ScheduleAwaiter(*this);
+            }
+
+            /**
+             * Awaitable that suspends the calling coroutine until `fd` is readable, has hung up or has an error, and
+             * then resumes it on one of the pool's threads. With a negative `fd` it behaves like `schedule()`.
+             */
+            ReadableAwaiter readable(int fd) noexcept {
+                return ReadableAwaiter(*this, fd);
+            }
+
+            std::size_t num_threads() const noexcept {
+                return threads_.size();
+            }
+
+            /**
+             * Number of threads that fits the CPUs returned by `resource_limits()`.
+             */
+            static std::size_t default_num_threads() {
+                return num_worker_threads(resource_limits());
+            }
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                std::deque<std::coroutine_handle<>> handles;
+            };
+
+            static ThreadPool *&current_pool() noexcept {
+                static thread_local ThreadPool *pool = nullptr;
+                return pool;
+            }
+
+            static std::size_t &current_index() noexcept {
+                static thread_local std::size_t index = 0;
+                return index;
+            }
+
+            void enqueue(std::coroutine_handle<> handle) {
+                const std::size_t index = (current_pool() == this) ?
+                                                  current_index() :
+                                                  (next_.fetch_add(1, std::memory_order_relaxed) % queues_.size());
+                {
+                    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+                    queues_[index]->handles.push_back(handle);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    num_pending_++;
+                }
+                cv_.notify_one();
+            }
+
+            void enqueue_when_readable(int fd, std::coroutine_handle<> handle) {
+                if ((fd < 0) || !poller_.joinable()) {
+                    enqueue(handle);
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(readable_mutex_);
+                    waiting_.emplace_back(fd, handle);
+                }
+                wake_poller();
+            }
+
+            void wake_poller() {
+                const char byte = 1;
+                while ((write(wake_fds_[1], &byte, 1) < 0) && (errno == EINTR)) {
+                }
+            }
+
+            void poll_readable() {
+                std::vector<pollfd> fds;
+                std::vector<std::coroutine_handle<>> handles;
+                while (true) {
+                    fds.assign(1, pollfd{wake_fds_[0], POLLIN, 0});
+                    handles.clear();
+                    {
+                        std::lock_guard<std::mutex> lock(readable_mutex_);
+                        if (stop_polling_) {
+                            return;
+                        }
+                        for (const auto &[fd, handle] : waiting_) {
+                            fds.push_back(pollfd{fd, POLLIN, 0});
+                            handles.push_back(handle);
+                        }
+                    }
+
+                    if (poll(fds.data(), static_cast<nfds_t>(fds.size()), -1) < 0) {
+                        continue;
+                    }
+
+                    if (fds[0].revents != 0) {
+                        char bytes[64];
+                        while (read(wake_fds_[0], bytes, sizeof(bytes)) > 0) {
+                        }
+                    }
+
+                    for (std::size_t i = 1; i < fds.size(); i++) {
+                        if (fds[i].revents == 0) {
+                            continue;
+                        }
+                        {
+                            std::lock_guard<std::mutex> lock(readable_mutex_);
+                            std::erase_if(waiting_, [&](const auto &waiting) {
+                                return waiting.second == handles[i - 1];
+                            });
+                        }
+                        enqueue(handles[i - 1]);
+                    }
+                }
+            }
+
+            std::coroutine_handle<> take(std::size_t index) {
+                for (std::size_t i = 0; i < queues_.size(); i++) {
+                    Queue &queue = *queues_[(index + i) % queues_.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (!queue.handles.empty()) {
+                        std::coroutine_handle<> handle;
+                        if (i == 0) {
+                            handle = queue.handles.front();
+                            queue.handles.pop_front();
+                        } else {
+                            handle = queue.handles.back();
+                            queue.handles.pop_back();
+                        }
+                        return handle;
+                    }
+                }
+                return nullptr;
+            }
+
+            void run(std::size_t index) {
+                current_pool() = this;
+                current_index() = index;
+
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        cv_.wait(lock, [this] { return stop_ || (num_pending_ > 0); });
+                        if (num_pending_ == 0) {
+                            return;
+                        }
+                        num_pending_--;
+                    }
+
+                    std::coroutine_handle<> handle = take(index);
+                    if (handle) {
+                        handle.resume();
+                    }
+                }
+            }
+
+            std::vector<std::unique_ptr<Queue>> queues_;
+            std::vector<std::thread> threads_;
+            std::atomic<std::size_t> next_ = 0;
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            std::size_t num_pending_ = 0;
+            bool stop_ = false;
+
+            std::thread poller_;
+            int wake_fds_[2] = {-1, -1};
+            std::mutex readable_mutex_;
+            std::vector<std::pair<int, std::coroutine_handle<>>> waiting_;
+            bool stop_polling_ = false;
+        };
+
+        /**
+         * Runs a scoring pipeline as a detached task on `pool`, handing every score vector to `sink`. The task yields its
+         * thread back to the pool every `frames_per_slice` frames so that many streams can share a few threads. When
+         * the pipeline yields empty scores, i.e. its non-blocking source has no data, the task is suspended until
+         * `source_fd` is readable.
+         *
+         * @param pool Executor.
+         * @param scores Inference stage, typically `score(eagle, frames(read_pcm(fd, n), Eagle::frame_length()), status)`.
+         * @param sink Callable invoked with a `Span<const float>` for every frame, always from a pool thread.
+         * @param on_done Callable invoked once the stream ends.
+         * @param frames_per_slice Number of frames processed before yielding to other tasks.
+         * @param source_fd Descriptor read by the pipeline's source, or -1 if it never runs dry.
+         */
+        template<typename Sink, typename OnDone>
+        Task run_pipeline(
+                ThreadPool &pool,
+                Generator<Span<const float>> scores,
+                Sink sink,
+                OnDone on_done,
+                std::size_t frames_per_slice = 32,
+                int source_fd = -1) {
+            co_await pool.schedule();
+
+            std::size_t num_frames = 0;
+            for (Span<const float> frame_scores : scores) {
+                if (frame_scores.empty()) {
+                    co_await pool.readable(source_fd);
+                    continue;
+                }
+
+                sink(frame_scores);
+                if ((++num_frames % frames_per_slice) == 0) {
+                    co_await pool.schedule();
+                }
+            }
+
+            on_done();
+        }
+
+    } // namespace eagle
+} // namespace pv
+
+#endif // PV_EAGLE_PIPELINE_HPP
@@ -0,0 +1,177 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_RESOURCES_HPP
+#define PV_EAGLE_RESOURCES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+
+#include <sched.h>
+
+#endif
+
+/**
+ * Header-only C++17 helpers for sizing worker threads and instance pools from the resources the process may actually
+ * use, which inside a container are set by its cgroup rather than by the host.
+ */
+namespace pv {
+    namespace eagle {
+
+        /**
+         * CPU and memory available to the process.
+         */
+        struct ResourceLimits {
+            /**
+             * Number of CPUs the process can keep busy: the smallest of the CPU affinity mask and the cgroup v2
+             * `cpu.max` quota of the process's cgroup and its ancestors. It is fractional under a fractional quota.
+             */
+            double cpus;
+
+            /**
+             * Smallest cgroup v2 `memory.max` of the process's cgroup and its ancestors, or 0 if memory is not
+             * limited.
+             */
+            std::size_t memory_bytes;
+
+            /**
+             * Whether either value comes from a cgroup limit rather than from the host.
+             */
+            bool is_cgroup_limited;
+        };
+
+        namespace detail {
+
+            /**
+             * Reads the first line of `path` that starts with `prefix`.
+             */
+            inline bool read_line(const std::string &path, const char *prefix, char *line, int size) {
+                FILE *file = fopen(path.c_str(), "r");
+                if (!file) {
+                    return false;
+                }
+                bool is_found = false;
+                while (!is_found && (fgets(line, size, file) != nullptr)) {
+                    is_found = strncmp(line, prefix, strlen(prefix)) == 0;
+                }
+                fclose(file);
+                return is_found;
+            }
+
+            /**
+             * Lowers `limits` to the cgroup v2 limits of the cgroup at `relative_path` under `root` and of all its
+             * ancestors, since the limits of every ancestor apply as well.
+             */
+            inline void apply_cgroup_limits(
+                    const std::string &root,
+                    std::string relative_path,
+                    ResourceLimits &limits) {
+                char line[256];
+                for (;;) {
+                    const std::string directory = root + ((relative_path == "/") ? "" : relative_path);
+
+                    double quota = 0.0;
+                    double period = 0.0;
+                    if (read_line(directory + "/cpu.max", "", line, sizeof(line)) &&
+                        (sscanf(line, "%lf %lf", &quota, &period) == 2) && (quota > 0.0) && (period > 0.0) &&
+                        ((quota / period) < limits.cpus)) {
+                        limits.cpus = quota / period;
+                        limits.is_cgroup_limited = true;
+                    }
+
+                    if (read_line(directory + "/memory.max", "", line, sizeof(line)) &&
+                        (strncmp(line, "max", 3) != 0)) {
+                        const std::size_t memory_bytes = static_cast<std::size_t>(strtoull(line, nullptr, 10));
+                        if ((memory_bytes > 0) &&
+                            ((limits.memory_bytes == 0) || (memory_bytes < limits.memory_bytes))) {
+                            limits.memory_bytes = memory_bytes;
+                            limits.is_cgroup_limited = true;
+                        }
+                    }
+
+                    if (relative_path.empty() || (relative_path == "/")) {
+                        break;
+                    }
+                    const std::size_t slash = relative_path.find_last_of('/');
+                    relative_path = (slash == 0) ? "/" : relative_path.substr(0, slash);
+                }
+            }
+
+        } // namespace detail
+
+        /**
+         * Reads the resources available to the process. Inside a container the process sees every host core, but its
+         * cgroup usually has a CPU quota and a memory limit; sizing thread pools from
+         * `std::thread::hardware_concurrency()` alone oversubscribes the quota and gets the process throttled.
+         */
+        inline ResourceLimits resource_limits() {
+            const unsigned int num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+            ResourceLimits limits = {static_cast<double>(num_cpus), 0, false};
+
+#if defined(__linux__)
+
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+                limits.cpus = std::min(limits.cpus, static_cast<double>(CPU_COUNT(&cpu_set)));
+            }
+
+            // the cgroup v2 entry of /proc/self/cgroup reads `0::/path`, relative to the cgroup2 mount
+            char line[4096];
+            if (detail::read_line("/proc/self/cgroup", "0::", line, sizeof(line))) {
+                std::string relative_path(line + 3);
+                relative_path.erase(relative_path.find_last_not_of("\n") + 1);
+                detail::apply_cgroup_limits("/sys/fs/cgroup", relative_path, limits);
+            }
+
+#endif
+
+            return limits;
+        }
+
+        /**
+         * Number of worker threads that fits `limits.cpus`. A fractional quota is rounded down, since a thread that
+         * exhausts the quota stalls for the rest of the period, possibly in the middle of a frame.
+         */
+        inline std::size_t num_worker_threads(const ResourceLimits &limits) {
+            return std::max<std::size_t>(static_cast<std::size_t>(std::floor(limits.cpus)), 1);
+        }
+
+        /**
+         * Caps `num_instances` so that `baseline_bytes` plus that many instances of `instance_bytes` each stay within
+         * three quarters of `limits.memory_bytes`, keeping the rest as headroom. Returns `num_instances` unchanged if
+         * memory is not limited or the cost of an instance is unknown, and never less than one.
+         */
+        inline std::size_t max_num_instances(
+                const ResourceLimits &limits,
+                std::size_t baseline_bytes,
+                std::size_t instance_bytes,
+                std::size_t num_instances) {
+            if ((limits.memory_bytes == 0) || (instance_bytes == 0)) {
+                return num_instances;
+            }
+            const std::size_t budget_bytes = (limits.memory_bytes / 4) * 3;
+            const std::size_t max_instances = (budget_bytes - std::min(baseline_bytes, budget_bytes)) / instance_bytes;
+            return std::max<std::size_t>(std::min(num_instances, max_instances), 1);
+        }
+
+    } // namespace eagle
+} // namespace pv
+
+#endif // PV_EAGLE_RESOURCES_HPP
@@ -0,0 +1,211 @@
+/*
+    Copyright 2023 Picovoice Inc.
+
+    You may not use this file except in compliance with the license. A copy of the license is located in the "LICENSE"
+    file accompanying this source.
+
+    Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+    an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+    specific language governing permissions and limitations under the License.
+*/
+
+#ifndef PV_EAGLE_VERIFIER_HPP
+#define PV_EAGLE_VERIFIER_HPP
+
+#include <cmath>
+
+#include "pv_eagle.hpp"
+
+/**
+ * One-to-one speaker verification with early decisions on top of `pv_eagle.hpp`.
+ *
+ * `Verifier` runs Wald's sequential probability ratio test on the scores Eagle reports for a single claimed speaker.
+ * Each observation adds the log-likelihood ratio of the score under a genuine and an impostor score distribution to the
+ * accumulated evidence. Once the evidence crosses the threshold implied by the target false accept rate the claim is
+ * accepted, once it crosses the threshold implied by the target false reject rate it is rejected, and in between more
+ * audio is needed. Clear-cut utterances are therefore decided after a fraction of the audio, and the caller can stop
+ * feeding frames as soon as a decision is reached.
+ */
+namespace pv {
+    namespace eagle {
+
+        enum class Decision {
+            ACCEPT,
+            REJECT,
+            CONTINUE,
+        };
+
+        /**
+         * Parameters of the sequential test. The score distributions are modelled as normal distributions with a shared
+         * standard deviation; the defaults are a starting point and should be calibrated on scores of genuine and
+         * impostor utterances recorded in the target environment.
+         */
+        struct VerifierConfig {
+            /**
+             * Target probability of accepting an impostor, in (0, 1).
+             */
+            double false_accept_rate = 0.01;
+
+            /**
+             * Target probability of rejecting the claimed speaker, in (0, 1).
+             */
+            double false_reject_rate = 0.05;
+
+            /**
+             * Mean score of frames spoken by the claimed speaker.
+             */
+            double genuine_mean = 0.75;
+
+            /**
+             * Mean score of frames spoken by someone else. It must be lower than `genuine_mean`.
+             */
+            double impostor_mean = 0.25;
+
+            /**
+             * Standard deviation of the scores under both hypotheses.
+             */
+            double score_stddev = 0.2;
+
+            /**
+             * Number of frames per observation. Eagle's scores are smoothed over time, so consecutive frames are far
+             * from independent; only the score of the last frame of every group is used as evidence, which keeps the
+             * test from becoming overconfident.
+             */
+            int32_t frames_per_observation = 8;
+
+            /**
+             * Number of frames after which the test is truncated and decided by the sign of the accumulated evidence,
+             * or 0 to keep going until one of the thresholds is crossed.
+             */
+            int32_t max_frames = 0;
+        };
+
+        /**
+         * Verifies a claimed identity from a stream of audio frames. It is move-only, like the `Eagle` instance it owns.
+         */
+        class Verifier {
+        public:
+            /**
+             * Constructor.
+             *
+             * @param access_key AccessKey obtained from Picovoice Console (https://console.picovoice.ai/).
+             * @param model_path Absolute path to the file containing model parameters.
+             * @param claimed_profile Profile of the speaker whose identity is claimed.
+             * @param config Parameters of the sequential test.
+             * @return Verifier object, `PV_STATUS_INVALID_ARGUMENT` if `config` is inconsistent, or the status returned
+             * by `pv_eagle_init()`.
+             */
+            static Expected<Verifier> create(
+                    const char *access_key,
+                    const char *model_path,
+                    const Profile &claimed_profile,
+                    const VerifierConfig &config = VerifierConfig()) {
+                if ((config.false_accept_rate <= 0.0) || (config.false_reject_rate <= 0.0) ||
+                    ((config.false_accept_rate + config.false_reject_rate) >= 1.0) ||
+                    (config.genuine_mean <= config.impostor_mean) || (config.score_stddev <= 0.0) ||
+                    (config.frames_per_observation < 1) || (config.max_frames < 0)) {
+                    return Error(PV_STATUS_INVALID_ARGUMENT);
+                }
+
+                Expected<Eagle> eagle = Eagle::create(access_key, model_path, Span<const Profile>(&claimed_profile, 1));
+                if (!eagle) {
+                    return eagle.error();
+                }
+                return Verifier(std::move(eagle).value(), config);
+            }
+
+            /**
+             * Processes a frame of audio and updates the decision. Once the decision is `ACCEPT` or `REJECT` it is
+             * final: further frames are not processed and the same decision is returned until `reset()`.
+             *
+             * @param pcm A frame of `Eagle::frame_length()` samples.
+             * @return The current decision, or the status of `Eagle::process()`.
+             */
+            Expected<Decision> process(Span<const int16_t> pcm) noexcept {
+                if (decision_ != Decision::CONTINUE) {
+                    return decision_;
+                }
+
+                float score = 0.0f;
+                const Expected<void> status = eagle_.process(pcm, Span<float>(&score, 1));
+                if (!status) {
+                    return status.error();
+                }
+                num_frames_++;
+
+                if ((num_frames_ % config_.frames_per_observation) == 0) {
+                    log_likelihood_ratio_ += observation_log_likelihood_ratio(score);
+                    if (log_likelihood_ratio_ >= accept_threshold_) {
+                        decision_ = Decision::ACCEPT;
+                    } else if (log_likelihood_ratio_ <= reject_threshold_) {
+                        decision_ = Decision::REJECT;
+                    }
+                }
+
+                if ((decision_ == Decision::CONTINUE) && (config_.max_frames > 0) &&
+                    (num_frames_ >= config_.max_frames)) {
+                    decision_ = (log_likelihood_ratio_ > 0.0) ? Decision::ACCEPT : Decision::REJECT;
+                }
+
+                return decision_;
+            }
+
+            /**
+             * Starts a new verification, clearing the evidence and the engine's internal state.
+             */
+            Expected<void> reset() noexcept {
+                decision_ = Decision::CONTINUE;
+                log_likelihood_ratio_ = 0.0;
+                num_frames_ = 0;
+                return eagle_.reset();
+            }
+
+            Decision decision() const noexcept {
+                return decision_;
+            }
+
+            /**
+             * Accumulated log-likelihood ratio of the claimed speaker against an impostor.
+             */
+            double log_likelihood_ratio() const noexcept {
+                return log_likelihood_ratio_;
+            }
+
+            /**
+             * Number of frames processed since construction or the last `reset()`.
+             */
+            int32_t num_frames() const noexcept {
+                return num_frames_;
+            }
+
+            const VerifierConfig &config() const noexcept {
+                return config_;
+            }
+
+        private:
+            Verifier(Eagle eagle, const VerifierConfig &config) noexcept
+                : eagle_(std::move(eagle)),
+                  config_(config),
+                  accept_threshold_(std::log((1.0 - config.false_reject_rate) / config.false_accept_rate)),
+                  reject_threshold_(std::log(config.false_reject_rate / (1.0 - config.false_accept_rate))) {}
+
+            double observation_log_likelihood_ratio(float score) const noexcept {
+                const double genuine_distance = static_cast<double>(score) - config_.genuine_mean;
+                const double impostor_distance = static_cast<double>(score) - config_.impostor_mean;
+                return ((impostor_distance * impostor_distance) - (genuine_distance * genuine_distance)) /
+                       (2.0 * config_.score_stddev * config_.score_stddev);
+            }
+
+            Eagle eagle_;
+            VerifierConfig config_;
+            double accept_threshold_;
+            double reject_threshold_;
+            Decision decision_ = Decision::CONTINUE;
+            double log_likelihood_ratio_ = 0.0;
+            int32_t num_frames_ = 0;
+        };
+
+    } // namespace eagle
+} // namespace pv
+
+#endif // PV_EAGLE_VERIFIER_HPP